@@ -11,7 +11,8 @@ callbacks pretty challenging. Currently, callbacks need to be implemented in the
 program, but suggestions for a better implementation are welcome.
 
 Place the Button_Debounce_Interrupt function under the appropriate timer interrupt flag
-in the user program.
+in the user program. With BTN_USE_SWT, the debounce runs on software timer SWT_ID_BTN
+instead, Button_Poll handles its expiry and BTN_TIMER is left free.
 
 
 LOGIC:
@@ -37,6 +38,9 @@ NOTE:
 
 	Similarly, releasing the buttons sets the PxDIER register to 0.
 
+	With PERIPH_ILRC and an ILRC debounce clock, the bound is solved from
+	ilrc_hz. Call Button_Update_Timing after each ILRC_Calibrate.
+
 
 ROM Consumed : 116B / 0x74  -  1 Port
 RAM Consumed :  18B / 0x12  -  1 Port
@@ -57,6 +61,13 @@ Copyright (c) 2021 Robert R. Puccinelli
 #include "system_settings.h"
 
 #IF PERIPH_BUTTON
+#if BTN_USE_SWT
+	#include "pdk_swtimer.h"
+#endif
+#if BTN_ILRC_CAL
+	#include "pdk_math.h"
+	#include "pdk_ilrc.h"
+#endif
 
 //======================//
 // VARIABLES AND MACROS //
@@ -92,6 +103,9 @@ BYTE button_enabled_c;
 // Number of counts to wait before firing debouncer interrupt
 TIMER_BOUND		=>	BTN_TIMER_FREQ / (BTN_TIMER_DIV + 1) / (1000 / BTN_DEBOUNCE_T);
 
+// Timer Hz per count of bound, for the bound from ilrc_hz
+TIMER_DIVISOR	=>	(BTN_TIMER_DIV + 1) * (1000 / BTN_DEBOUNCE_T);
+
 
 //==================//
 // STATIC FUNCTIONS //
@@ -99,8 +113,15 @@ TIMER_BOUND		=>	BTN_TIMER_FREQ / (BTN_TIMER_DIV + 1) / (1000 / BTN_DEBOUNCE_T);
 
 void Start_Debounce_Timer(void)
 {
-	BTN_TIMER_CNT = 0;
-	$ BTN_TIMER_CTL BTN_TIMER_CLK;
+	#if BTN_USE_SWT
+		swt_id     = SWT_ID_BTN;
+		swt_ticks  = BTN_SWT_TICKS;
+		swt_period = 0;
+		SWT_Start();
+	#else
+		BTN_TIMER_CNT = 0;
+		$ BTN_TIMER_CTL BTN_TIMER_CLK;
+	#endif
 }
 
 
@@ -109,16 +130,41 @@ void Start_Debounce_Timer(void)
 //===================//
 
 
+// UPDATE TIMING
+// Reload the debounce bound. With BTN_ILRC_CAL it is solved from ilrc_hz,
+// so call this again after ILRC_Calibrate.
+void Button_Update_Timing(void)
+{
+	#if BTN_ILRC_CAL
+		math_dividend = ilrc_hz;
+		math_divisor  = TIMER_DIVISOR;
+		eword_divide();
+
+		if      (math_quotient > 255) BTN_TIMER_BND = 255;
+		else if (!math_quotient)      BTN_TIMER_BND = 1;
+		else                          BTN_TIMER_BND = math_quotient$0;
+	#else
+		#ifz BTN_USE_SWT
+			BTN_TIMER_BND = TIMER_BOUND;
+		#endif
+	#endif
+}
+
+
 // INITIALIZE
 void Button_Initialize(void)
 {
 	// Set pins to button state and allow button function calls
 
 	// Configure debounce timer
-	$ BTN_TIMER_CTL STOP;
-	BTN_TIMER_CNT = 0;
-	BTN_TIMER_BND = TIMER_BOUND;
-	BTN_TIMER_SCL = BTN_TIMER_DIV;
+	#if BTN_USE_SWT
+		SWT_Initialize();
+	#else
+		$ BTN_TIMER_CTL STOP;
+		BTN_TIMER_CNT = 0;
+		BTN_TIMER_SCL = BTN_TIMER_DIV;
+		Button_Update_Timing();
+	#endif
 
 	// PORT A
 	#if BTN_USE_PA
@@ -154,8 +200,10 @@ void Button_Initialize(void)
 		button_active_c   = 0;
 	#endif
 
-	INTRQ.BTN_TIMER = 0;					// Ensure that timer interrupt is cleared
-	INTEN.BTN_TIMER = 1;					// Enable timer interrupt
+	#ifz BTN_USE_SWT
+		INTRQ.BTN_TIMER = 0;				// Ensure that timer interrupt is cleared
+		INTEN.BTN_TIMER = 1;				// Enable timer interrupt
+	#endif
 	button_module_initialized = 1;			// Enable other functions in module
 }
 
@@ -165,6 +213,15 @@ void Button_Poll(void)
 {
 	if (button_module_initialized){
 
+		// Debounce period over
+		#if BTN_USE_SWT
+			if (swt_expired.SWT_ID_BTN)
+			{
+				swt_expired.SWT_ID_BTN = 0;
+				Button_Debounce_Interrupt();
+			}
+		#endif
+
 		// Find falling edges and start debouncing timer
 		trigger_debounce = 0;
 
@@ -210,7 +267,9 @@ void Button_Debounce_Interrupt(void)
 	if (button_module_initialized){
 
 		// If pins being watched are still low, mark them active
-		$ BTN_TIMER_CTL STOP;
+		#ifz BTN_USE_SWT
+			$ BTN_TIMER_CTL STOP;
+		#endif
 
 		// PORT A
 		#if BTN_USE_PA
@@ -227,7 +286,9 @@ void Button_Debounce_Interrupt(void)
 			button_debounce_c = 0;
 		#endif
 
-		INTRQ.BTN_TIMER = 0;								// Clear timer interrupt flag
+		#ifz BTN_USE_SWT
+			INTRQ.BTN_TIMER = 0;							// Clear timer interrupt flag
+		#endif
 	}
 }
 
@@ -262,6 +323,11 @@ void Button_Release(void)
 			$ PCDIER 0;
 			button_active_c = 0;					
 		#endif
+
+		#if BTN_USE_SWT
+			swt_id = SWT_ID_BTN;
+			SWT_Stop();
+		#endif
 	
 		button_module_initialized = 0;	// Disable functions in module
 	}
@@ -25,6 +25,9 @@ NOTE:
 
 	Similarly, releasing the buttons sets the PxDIER register to 0.
 
+	With PERIPH_ILRC and an ILRC debounce clock, the bound is solved from
+	ilrc_hz. Call Button_Update_Timing after each ILRC_Calibrate.
+
 
 ROM Consumed : 116B / 0x74  -  1 Port
 RAM Consumed :  18B / 0x12  -  1 Port
@@ -54,5 +57,6 @@ EXTERN BYTE 	button_active_c;
 void	Button_Initialize	    	(void);
 void    Button_Poll             	(void);
 void	Button_Debounce_Interrupt   (void);
+void	Button_Update_Timing        (void);
 void	Button_Release		    	(void);
 
@@ -5,6 +5,8 @@ EEPROM definitions for Padauk microcontrollers.
 ROM Consumed : 96B / 0x60
 RAM Consumed : 15B / 0x0F  -  USING 4B BUFFER
 
+ROM Consumed + ~60B / 0x3C  -  WITH I2C_ASYNC
+
 
 USAGE NOTE:
 
@@ -12,6 +14,16 @@ USAGE NOTE:
 	number of data bytes to process and the second byte is the EEPROM device ID.
 	The N bytes after are used for reading or writing data. The first byte specifies
 	how many of these bytes will be processed.
+
+ASYNC NOTE:
+
+	With I2C_ASYNC set, EEPROM_Write_Async and EEPROM_Read_Async queue the
+	same transfers on the I2C engine and return at once. The slot is in
+	i2c_async_slot, 0xFF when nothing was queued. The buffer must stay
+	untouched until the slot's bit is set in i2c_async_done. They do not
+	wait for a previous write cycle. Queue EEPROM_Poll_Async first and
+	repeat it while its slot ends in i2c_async_nack. With EEPROM_WRITE_CTL
+	set, call EEPROM_Write_Disable once the write slot is done.
 	
 
 This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
@@ -118,23 +130,14 @@ void EEPROM_Read (void)
 			EEPROM_Delay_While_Busy();
 			#ifidni EEPROM_COMM_MODE, I2C
 
-				// Set read address
+				// Set read address, then read after a repeated start
 				i2c_device = eeprom_device_addr;
-				I2C_Stream_Write_Start();
-				i2c_buffer = *eeprom_trx_buffer++;
-				I2C_Stream_Write_Byte();
-				I2C_Stream_Stop();
-
-				// Start reading
-				I2C_Stream_Read_Start();
-				while (--count) 
-				{
-					i2c_buffer = eeprom_trx_buffer++;
-					I2C_Stream_Read_Byte_Ack(); 
-				}
-				i2c_buffer = *eeprom_trx_buffer;
-				I2C_Stream_Read_Byte_NAck();
-				I2C_Stream_Stop();
+				i2c_wr_ptr = eeprom_trx_buffer;
+				i2c_wr_len = 1;
+				i2c_rd_ptr = eeprom_trx_buffer;
+				i2c_rd_ptr++;
+				i2c_rd_len = count;
+				I2C_Write_Read();
 			#endif
 		}
 	}
@@ -151,20 +154,78 @@ void EEPROM_Write (void)
 			EEPROM_Delay_While_Busy();
 			EEPROM_Write_Enable();
 			#ifidni EEPROM_COMM_MODE, I2C
+				// Address byte followed by count data bytes
 				i2c_device = eeprom_device_addr;
-				I2C_Stream_Write_Start();
-				do 
-				{
-					i2c_buffer = *eeprom_trx_buffer++;
-					I2C_Stream_Write_Byte(); 
-				} while(--count);
-				i2c_buffer = *eeprom_trx_buffer;
-				I2C_Stream_Write_Byte();
-				I2C_Stream_Stop();
+				i2c_wr_ptr = eeprom_trx_buffer;
+				i2c_wr_len = count;
+				i2c_wr_len++;
+				i2c_rd_len = 0;
+				I2C_Write_Read();
 			#endif
 			EEPROM_Write_Disable();
 		}
 	}
 }
 
+
+#ifidni EEPROM_COMM_MODE, I2C
+#IF I2C_ASYNC
+
+// Queue an address only transaction. Slave nack means a write cycle is running.
+void EEPROM_Poll_Async (void)
+{
+	i2c_async_slot = 0xFF;
+	if (eeprom_module_initialized)
+	{
+		i2c_device = eeprom_device_addr;
+		i2c_wr_len = 0;
+		i2c_rd_len = 0;
+		I2C_Async_Submit();
+	}
+}
+
+
+void EEPROM_Read_Async (void)
+{
+	i2c_async_slot = 0xFF;
+	if (eeprom_module_initialized)
+	{
+		count = *eeprom_trx_buffer++;
+		if (count <= EEPROM_PAGE_SIZE)
+		{
+			i2c_device = eeprom_device_addr;
+			i2c_wr_ptr = eeprom_trx_buffer;
+			i2c_wr_len = 1;
+			i2c_rd_ptr = eeprom_trx_buffer;
+			i2c_rd_ptr++;
+			i2c_rd_len = count;
+			I2C_Async_Submit();
+		}
+	}
+}
+
+
+// ~WC stays enabled until EEPROM_Write_Disable, see ASYNC NOTE
+void EEPROM_Write_Async (void)
+{
+	i2c_async_slot = 0xFF;
+	if (eeprom_module_initialized)
+	{
+		count = *eeprom_trx_buffer++;
+		if (count <= EEPROM_PAGE_SIZE)
+		{
+			EEPROM_Write_Enable();
+			i2c_device = eeprom_device_addr;
+			i2c_wr_ptr = eeprom_trx_buffer;
+			i2c_wr_len = count;
+			i2c_wr_len++;
+			i2c_rd_len = 0;
+			I2C_Async_Submit();
+		}
+	}
+}
+
+#ENDIF // I2C_ASYNC
+#endif
+
 #ENDIF // PERIPH_EEPROM
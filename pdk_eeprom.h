@@ -6,6 +6,8 @@ EEPROM declarations for Padauk microcontrollers.
 ROM Consumed : 96B / 0x60
 RAM Consumed : 15B / 0x0F  -  USING 4B BUFFER
 
+ROM Consumed + ~60B / 0x3C  -  WITH I2C_ASYNC
+
 
 USAGE NOTE:
 
@@ -14,6 +16,16 @@ USAGE NOTE:
 	The N bytes after are used for reading or writing data. The first byte specifies
 	how many of these bytes will be processed.
 
+ASYNC NOTE:
+
+	With I2C_ASYNC set, EEPROM_Write_Async and EEPROM_Read_Async queue the
+	same transfers on the I2C engine and return at once. The slot is in
+	i2c_async_slot, 0xFF when nothing was queued. The buffer must stay
+	untouched until the slot's bit is set in i2c_async_done. They do not
+	wait for a previous write cycle. Queue EEPROM_Poll_Async first and
+	repeat it while its slot ends in i2c_async_nack. With EEPROM_WRITE_CTL
+	set, call EEPROM_Write_Disable once the write slot is done.
+
 	
 This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
 Any modifications or distributions have to be licensed under GPLv3.
@@ -38,4 +50,9 @@ EXTERN WORD eeprom_trx_buffer;		// Pointer to array : [NumOps, Addr, Op1, Op2, .
 void EEPROM_Initialize (void);
 void EEPROM_Release    (void);
 void EEPROM_Read       (void);
-void EEPROM_Write      (void);
\ No newline at end of file
+void EEPROM_Write      (void);
+
+void EEPROM_Poll_Async    (void); // I2C_ASYNC only, see ASYNC NOTE
+void EEPROM_Read_Async    (void); // I2C_ASYNC only
+void EEPROM_Write_Async   (void); // I2C_ASYNC only
+void EEPROM_Write_Disable (void); // After an async write, with EEPROM_WRITE_CTL
\ No newline at end of file
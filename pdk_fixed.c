@@ -0,0 +1,238 @@
+/* pdk_fixed.c
+
+Unsigned fixed point Q8.8 and Q16.16 arithmetic built on pdk_math.
+Define PERIPH_FIXED in system_settings.h
+
+ROM Consumed : 284B / 0x11C  -  EXCLUDING pdk_math
+RAM Consumed :   0B / 0x00   -  Shares pdk_math scratch registers
+
+
+NOTE:
+
+	Operands and results live in the pdk_math scratch registers, so a fixed point
+	call clobbers any math_* value that is in flight.
+
+	Q8.8 results are formed from the middle bytes of the word_multiply product
+	and Q16.16 results from the middle bytes of the dword_multiply product.
+	Division shifts the dividend up by the fraction width before dividing.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+#include "system_settings.h"
+
+#IF PERIPH_FIXED
+#include "pdk_math.h"
+#include "pdk_fixed.h"
+
+
+//===================//
+// PROGRAM FUNCTIONS //
+//===================//
+
+
+// Q8.8 //
+
+void q8_add(void)
+{
+	math_product  = math_mult_a;
+	math_product += math_mult_b;
+	if (math_product$2) math_product = 0xFFFF;
+}
+
+
+void q8_multiply(void)
+{
+	word_multiply();
+
+	// Round at the 1/2 LSB of the Q16.16 product
+	math_product$0 += 0x80;
+	addc math_product$1;
+	addc math_product$2;
+	addc math_product$3;
+
+	if (math_product$3) math_product = 0xFFFF;
+	else
+	{
+		math_product$0 = math_product$1;
+		math_product$1 = math_product$2;
+		math_product$2 = 0;
+	}
+}
+
+
+void q8_divide(void)
+{
+	if (!math_mult_b) math_product = 0xFFFF;
+	else
+	{
+		// (A << 8) / B
+		math_dividend$0 = 0;
+		math_dividend$1 = math_mult_a$0;
+		math_dividend$2 = math_mult_a$1;
+		math_dividend$3 = 0;
+		math_divisor    = math_mult_b;
+		eword_divide();
+
+		math_remainder <<= 1;
+		if (math_remainder >= math_divisor) math_quotient++;
+
+		if (math_quotient$2) math_product = 0xFFFF;
+	}
+}
+
+
+void q8_reciprocal(void)
+{
+	math_mult_b = math_mult_a;
+	math_mult_a = FIXED_Q8_ONE;
+	q8_divide();
+}
+
+
+void q8_round(void)
+{
+	math_product  = math_mult_a;
+	math_product += 0x80;
+
+	math_product$0 = math_product$1;
+	math_product$1 = 0;
+	if (math_product$2) math_product$0 = 0xFF;
+	math_product$2 = 0;
+}
+
+
+
+// Q16.16 //
+
+void q16_add(void)
+{
+	math_product  = math_mult_da;
+	math_product += math_mult_db;
+	if (CF) math_product = 0xFFFFFFFF;
+}
+
+
+void q16_multiply(void)
+{
+	dword_multiply();
+
+	// Round at the 1/2 LSB of the Q32.32 product
+	math_product$1 += 0x80;
+	addc math_product$2;
+	addc math_product$3;
+	addc math_product_h$0;
+	addc math_product_h$1;
+	addc math_product_h$2;
+	addc math_product_h$3;
+
+	if (math_product_h$2 || math_product_h$3) math_product = 0xFFFFFFFF;
+	else
+	{
+		math_product$0 = math_product$2;
+		math_product$1 = math_product$3;
+		math_product$2 = math_product_h$0;
+		math_product$3 = math_product_h$1;
+	}
+}
+
+
+void q16_divide(void)
+{
+	// (A << 16) / B. The upper 16 quotient bits are zero unless the result
+	// overflows, so the remainder starts preloaded with A >> 16.
+	math_dividend$0  = 0;
+	math_dividend$1  = 0;
+	math_dividend$2  = math_mult_da$0;
+	math_dividend$3  = math_mult_da$1;
+	math_product_h$0 = math_mult_da$2;
+	math_product_h$1 = math_mult_da$3;
+	math_product_h$2 = 0;
+	math_product_h$3 = 0;
+
+	// Overflow or divide by zero
+	if (math_product_h >= math_mult_db) math_product = 0xFFFFFFFF;
+	else
+	{
+		math_shift = 32;
+		do
+		{
+			sl  math_dividend$0;
+			slc math_dividend$1;
+			slc math_dividend$2;
+			slc math_dividend$3;
+
+			slc math_product_h$0;
+			slc math_product_h$1;
+			slc math_product_h$2;
+			slc math_product_h$3;
+
+			// Carry out of the remainder means it already exceeds the divisor
+			if (CF)
+			{
+				math_product_h -= math_mult_db;
+				math_quotient |= 0b1;
+			}
+			else if (math_product_h >= math_mult_db)
+			{
+				math_product_h -= math_mult_db;
+				math_quotient |= 0b1;
+			}
+
+		} while(--math_shift);
+
+		// Round to nearest. math_shift is 0 after the loop.
+		sl  math_product_h$0;
+		slc math_product_h$1;
+		slc math_product_h$2;
+		slc math_product_h$3;
+
+		if (CF) math_shift = 1;
+		else if (math_product_h >= math_mult_db) math_shift = 1;
+
+		// Carry out of the top only when 0xFFFFFFFF rounds up, saturate
+		if (math_shift)
+		{
+			math_quotient$0 += 1;
+			addc math_quotient$1;
+			addc math_quotient$2;
+			addc math_quotient$3;
+
+			if (CF) math_product = 0xFFFFFFFF;
+		}
+	}
+}
+
+
+void q16_reciprocal(void)
+{
+	math_mult_db = math_mult_da;
+	math_mult_da = FIXED_Q16_ONE;
+	q16_divide();
+}
+
+
+void q16_round(void)
+{
+	math_product = math_mult_da;
+	math_product$1 += 0x80;
+	addc math_product$2;
+	addc math_product$3;
+
+	if (CF) math_product = 0xFFFF;
+	else
+	{
+		math_product$0 = math_product$2;
+		math_product$1 = math_product$3;
+		math_product$2 = 0;
+		math_product$3 = 0;
+	}
+}
+
+#ENDIF // PERIPH_FIXED
@@ -0,0 +1,68 @@
+/* pdk_fixed.h
+
+Unsigned fixed point Q8.8 and Q16.16 arithmetic built on pdk_math.
+Define PERIPH_FIXED in system_settings.h
+
+ROM Consumed : 284B / 0x11C  -  EXCLUDING pdk_math
+RAM Consumed :   0B / 0x00   -  Shares pdk_math scratch registers
+
+
+NOTE:
+
+	Operands and results live in the pdk_math scratch registers, so a fixed point
+	call clobbers any math_* value that is in flight.
+
+		fixed_a  : Operand A.  Q8.8 uses the low WORD.
+		fixed_b  : Operand B.  Q8.8 uses the low WORD.
+		fixed_r  : Result.     Q8.8 uses the low WORD, round functions return
+		                       an integer BYTE (Q8.8) or WORD (Q16.16).
+
+	Results are rounded to the nearest LSB and saturate at the maximum value
+	on overflow or divide by zero.
+
+	Function maximum run time @ 4 MHz
+
+	                Q8.8     Q16.16
+	add             2   us   3   us
+	multiply        14  us   52  us  WITH MULTIPLIER
+	                67  us   166 us  WITHOUT MULTIPLIER
+	divide          152 us   215 us
+	reciprocal      153 us   216 us
+	round           3   us   3   us
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+
+//===========//
+// VARIABLES //
+//===========//
+
+#define fixed_a  math_mult_da
+#define fixed_b  math_mult_db
+#define fixed_r  math_product
+
+#define FIXED_Q8_ONE   0x0100
+#define FIXED_Q16_ONE  0x00010000
+
+
+//===================//
+// PROGRAM FUNCTIONS //
+//===================//
+
+void q8_add           (void);
+void q8_multiply      (void);
+void q8_divide        (void);
+void q8_reciprocal    (void);
+void q8_round         (void);
+
+void q16_add          (void);
+void q16_multiply     (void);
+void q16_divide       (void);
+void q16_reciprocal   (void);
+void q16_round        (void);
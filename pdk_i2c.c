@@ -4,13 +4,66 @@ I2C utilities based off of the PADAUK IDE v0.91 Code Generator.
 Define PERIPH_I2C in system_settings.h
 
 In the communication protocol provided here, the MSB is Tx/Rx first.
-Timings are configured for 100kHz with system_settings.h. Higher may
-be achievable, but it is currently untested.
+I2C_SPEED in system_settings.h selects 100kHz, 400kHz or 1MHz timing.
+Each delay is the profile time in instruction cycles at SYSTEM_CLOCK
+less the shortest code between the two bus edges (Code_xxx below), so
+no phase is shorter than the profile allows. Longer paths, mostly from
+one byte to the next, stretch SCL low by up to Code_Gap_Max - Code_Tx_Low
+cycles, so a transfer runs somewhat below the profile rate. The build
+stops with an error when the code alone is longer than a phase. At 2T,
+400kHz needs 16MHz SYSCLK. 1MHz is not reachable.
 
 ROM Consumed : 197B / 0xC5
 RAM Consumed :  12B / 0x0C
 
 
+ASYNCHRONOUS ENGINE:
+
+	The stream functions hold the CPU for the whole transfer. With I2C_ASYNC
+	set, I2C_Async_Submit queues a transaction and returns at once. A timer
+	interrupt then clocks the bus one half bit per tick, SCL = I2C_ASYNC_HZ / 2.
+
+	A transaction writes i2c_wr_len bytes from i2c_wr_ptr, then reads
+	i2c_rd_len bytes into i2c_rd_ptr after a repeated start, then stops.
+	Either length may be 0. Both 0 only sends the address, e.g. to poll an
+	EEPROM for its write cycle. Buffers must stay untouched until done.
+
+	I2C_Async_Submit copies the transaction to queue slot i2c_async_slot,
+	0xFF when the queue is full. The interrupt sets the slot's bit in
+	i2c_async_done when the transaction ends, and in i2c_async_nack as
+	well if the slave did not acknowledge. The rest of the transaction is
+	then skipped. i2c_async_busy stays set until the queue is empty and the
+	timer is stopped again.
+
+		if (i2c_async_done.0) { i2c_async_done.0 = 0; ... }
+
+	Place I2C_Async_Interrupt under the I2C_INTR flag in the Interrupt
+	function. The stream functions must not be used while i2c_async_busy
+	is set.
+
+	COST: The engine does not save CPU time, it spreads it out. A tick is
+	~30 instructions plus interrupt entry, ~15 us at 4 MHz SYSCLK, and a
+	byte with its ack takes 18 ticks. A 3 byte LCD write, start and stop
+	included, is ~64 ticks: ~0.9 ms of CPU and ~6.4 ms on the bus at the
+	default 10000 ticks/s. The stream functions send it in ~0.4 ms at
+	100kHz, all of it with the CPU held. What the engine buys is that the
+	main loop is never held for more than one tick, e.g. while it steps a
+	motor or scans buttons. While busy it takes ~15% of the CPU, none
+	while idle. A higher I2C_ASYNC_HZ shortens the bus time, not the CPU
+	cost. Use the stream functions when total CPU time matters more.
+
+	EEPROM_Write_Async, EEPROM_Read_Async and EEPROM_Poll_Async queue
+	EEPROM traffic on the engine, see pdk_eeprom.c. An ST7032 LCD takes a
+	control byte and then any number of data bytes, so text can be queued
+	as one write from a buffer holding [LCD_DATA_MODE, chars ...].
+
+	I2C_TIMER defaults to TM2, the default BTN_TIMER as well. The build
+	stops with an error when both are enabled on one timer. Set
+	BTN_USE_SWT or move one of them.
+
+	ROM ~330B, RAM 26B + 5B per queue slot
+
+
 This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
 Any modifications or distributions have to be licensed under GPLv3.
 No warranty of any kind and copyright holders cannot be held liable.
@@ -35,6 +88,57 @@ BYTE i2c_flags = 0;
 BIT  i2c_slave_ack_bit : i2c_flags.?;       // Slave acknowledge bit
 BIT  i2c_module_initialized : i2c_flags.?;  // Module function blocking flag
 
+WORD i2c_wr_ptr;                  // Transaction for I2C_Write_Read
+WORD i2c_rd_ptr;                  // and I2C_Async_Submit
+BYTE i2c_wr_len;
+BYTE i2c_rd_len;
+
+
+#IF I2C_ASYNC
+
+	BIT  i2c_async_busy  : i2c_flags.?;     // Set while transactions are queued
+	STATIC BIT i2c_as_phase   : i2c_flags.?; // 0: SCL low half, 1: SCL high half
+	STATIC BIT i2c_as_reading : i2c_flags.?; // Read address was sent
+
+	BYTE i2c_async_slot;                    // Slot used by the last submit, 0xFF: Full
+	BYTE i2c_async_done = 0;                // Bit per slot, set on completion, cleared by user
+	BYTE i2c_async_nack = 0;                // Bit per slot, set when the slave did not ack
+
+	// Queue, one slot per transaction
+	STATIC BYTE i2c_q_addr   [I2C_QUEUE];
+	STATIC BYTE i2c_q_wr_ptr [I2C_QUEUE];
+	STATIC BYTE i2c_q_wr_len [I2C_QUEUE];
+	STATIC BYTE i2c_q_rd_ptr [I2C_QUEUE];
+	STATIC BYTE i2c_q_rd_len [I2C_QUEUE];
+	STATIC BYTE i2c_q_head  = 0;
+	STATIC BYTE i2c_q_count = 0;
+	STATIC BYTE i2c_q_index;
+	STATIC BYTE i2c_q_mask;
+	STATIC BYTE i2c_q_n;
+	STATIC BYTE i2c_q_inten;	// Caller's INTEN during I2C_Async_Submit
+
+	// Transaction on the bus. Shared with the interrupt.
+	STATIC WORD i2c_as_ptr;
+	STATIC BYTE i2c_as_mask;
+	STATIC BYTE i2c_as_addr;
+	STATIC BYTE i2c_as_wr_ptr;
+	STATIC BYTE i2c_as_wr_len;
+	STATIC BYTE i2c_as_rd_ptr;
+	STATIC BYTE i2c_as_rd_len;
+	STATIC BYTE i2c_as_state = 0;
+	STATIC BYTE i2c_as_step;
+	STATIC BYTE i2c_as_shift;
+
+	// Engine states
+	I2C_AS_IDLE    =>  0;
+	I2C_AS_START   =>  1;
+	I2C_AS_TX      =>  2;
+	I2C_AS_RX      =>  3;
+	I2C_AS_RESTART =>  4;
+	I2C_AS_STOP    =>  5;
+
+#ENDIF
+
 
 
 // Delay cycles
@@ -45,6 +149,41 @@ Delay_Stop  =>  I2C_D_STOP;
 Delay_Buf   =>  I2C_D_BUF;
 
 
+// Instruction cycles from one bus edge to the next, delay excluded.
+// Counted on the shortest path through the code below, call/ret are 2.
+Code_Start     =>  1;  // set0 SCL
+Code_Tx_Low    =>  9;  // ret, sl, mov, call, sl, swapc, set1 SCL
+Code_Tx_High   =>  1;  // set0 SCL
+Code_Rx_Low    =>  5;  // ret, call, set1 SCL
+Code_Rx_High   =>  3;  // swapc, slc, set0 SCL
+Code_Ack_Low   => 11;  // ret, ret, ret, call, SDA Out Low, set1 SCL
+Code_Ack_High  =>  1;  // set0 SCL
+Code_Lstn_Low  =>  9;  // ret, sl, ret, call, SDA In, set1 SCL
+Code_Lstn_High =>  4;  // set0 ack, t0sn SDA, set1 ack, set0 SCL
+Code_Stop_Low  => 10;  // ret, ret, call, call, set0 SDA, set1 SCL
+Code_Rst_Low   => 11;  // SDA Out, ret, ret, call, call, set1 SDA, set1 SCL
+Code_Rst       =>  3;  // call, set0 SDA
+Code_Stop      =>  1;  // set1 SDA
+Code_Buf       =>  9;  // ret, ret, call, call, set0 SDA
+
+// Longest path, not used for delays. I2C_Listen_Ack to the first bit of
+// I2C_Write_Block in I2C_Write_Read: SDA Out, ret, ret, ret, call, if,
+// while, if, idxm, mov, call, mov, call, sl, swapc, set1 SCL
+Code_Gap_Max   => 27;
+
+// Bus speed check. The counts are shortest paths, so this only ensures
+// every phase can meet its minimum time. It does not hold the bit rate
+// on longer paths, see the header.
+#IF I2C_HZ
+	#IF (Code_Tx_Low > Delay_Low) || (Code_Rx_Low > Delay_Low) || (Code_Ack_Low > Delay_Low) || (Code_Lstn_Low > Delay_Low)
+		.error I2C_SPEED too fast for SYSTEM_CLOCK, code alone outlasts the SCL low time!
+	#ENDIF
+	#IF (Code_Tx_High > Delay_High) || (Code_Rx_High > Delay_High) || (Code_Ack_High > Delay_High) || (Code_Lstn_High > Delay_High)
+		.error I2C_SPEED too fast for SYSTEM_CLOCK, code alone outlasts the SCL high time!
+	#ENDIF
+#ENDIF
+
+
 // Offset target delay
 Easy_Delay	macro	val, cmp
 	#IF	val > cmp
@@ -60,7 +199,7 @@ Easy_Delay	macro	val, cmp
 static void I2C_Start (void)
 {
 	$ I2C_SDA	Low;
-	Easy_Delay	(Delay_Start, 1);
+	Easy_Delay	(Delay_Start, Code_Start);
 	$ I2C_SCL	Low;
 
 }
@@ -70,9 +209,9 @@ static void I2C_Tx_Bit (void)
 {
 	sl A;
 	swapc I2C_SDA;
-	Easy_Delay (Delay_Low, 8)
+	Easy_Delay (Delay_Low, Code_Tx_Low)
 	$ I2C_SCL High;
-	Easy_Delay (Delay_High, 0)
+	Easy_Delay (Delay_High, Code_Tx_High)
 	$ I2C_SCL Low;
 }
 
@@ -89,11 +228,11 @@ static void I2C_Tx_ACC (void)
 
 static void I2C_Rx_Bit (void)
 {
-	Easy_Delay (Delay_Low, 4)
+	Easy_Delay (Delay_Low, Code_Rx_Low)
 	$ I2C_SCL High;
 	swapc I2C_SDA;
 	slc i2c_buffer;
-	Easy_Delay (Delay_High, 2)
+	Easy_Delay (Delay_High, Code_Rx_High)
 	$ I2C_SCL Low;
 }
 
@@ -117,9 +256,9 @@ static void I2C_Read (void)
 static void I2C_Provide_Ack (void)
 {
 	$ I2C_SDA Out, Low;
-	Easy_Delay (Delay_Low, 2);
+	Easy_Delay (Delay_Low, Code_Ack_Low);
 	$ I2C_SCL High;
-	Easy_Delay (Delay_High, 1);
+	Easy_Delay (Delay_High, Code_Ack_High);
 	$ I2C_SCL Low;
 }
 
@@ -127,9 +266,9 @@ static void I2C_Provide_Ack (void)
 static void I2C_Provide_NAck (void)
 {
 	$ I2C_SDA Out, High;
-	Easy_Delay (Delay_Low, 2);
+	Easy_Delay (Delay_Low, Code_Ack_Low);
 	$ I2C_SCL High;
-	Easy_Delay (Delay_High, 1);
+	Easy_Delay (Delay_High, Code_Ack_High);
 	$ I2C_SCL Low;
 }
 
@@ -137,11 +276,11 @@ static void I2C_Provide_NAck (void)
 static void I2C_Listen_Ack (void)
 {
 	$ I2C_SDA In;
-	Easy_Delay (Delay_Low, 2);
+	Easy_Delay (Delay_Low, Code_Lstn_Low);
 	$ I2C_SCL High;
 	i2c_slave_ack_bit = 0;
 	if (I2C_SDA) {i2c_slave_ack_bit = 1;}
-	Easy_Delay (Delay_High, 3);
+	Easy_Delay (Delay_High, Code_Lstn_High);
 	$ I2C_SCL Low;
 	$ I2C_SDA Out;
 }
@@ -150,16 +289,141 @@ static void I2C_Listen_Ack (void)
 static void I2C_Stop (void)
 {
 	$ I2C_SDA	Low;
-	Easy_Delay (Delay_Low, 1);
+	Easy_Delay (Delay_Low, Code_Stop_Low);
 
 	$ I2C_SCL	High;
-	Easy_Delay (Delay_Stop, 1);
+	Easy_Delay (Delay_Stop, Code_Stop);
 
 	$ I2C_SDA	High;		
-	Easy_Delay (Delay_Buf, 1);
+	Easy_Delay (Delay_Buf, Code_Buf);
+}
+
+
+static void I2C_Restart (void)
+{
+	$ I2C_SDA	High;
+	Easy_Delay (Delay_Low, Code_Rst_Low);
+
+	$ I2C_SCL	High;
+	Easy_Delay (Delay_Start, Code_Rst);
+
+	I2C_Start();
+}
+
+
+#IF I2C_ASYNC
+
+//=====================//
+// ASYNCHRONOUS ENGINE //
+//=====================//
+
+// i2c_q_mask = 1 << i2c_q_index
+static void I2C_Slot_Mask (void)
+{
+	i2c_q_mask = 1;
+	i2c_q_n    = i2c_q_index;
+	while (i2c_q_n)
+	{
+		i2c_q_mask <<= 1;
+		i2c_q_n--;
+	}
 }
 
 
+// Copy the head slot to the bus transaction
+static void I2C_As_Load (void)
+{
+	i2c_q_index   = i2c_q_head;
+	I2C_Slot_Mask();
+	i2c_as_mask   = i2c_q_mask;
+
+	i2c_as_ptr    = i2c_q_addr;
+	i2c_as_ptr   += i2c_q_index;
+	i2c_as_addr   = *i2c_as_ptr;
+	i2c_as_ptr    = i2c_q_wr_ptr;
+	i2c_as_ptr   += i2c_q_index;
+	i2c_as_wr_ptr = *i2c_as_ptr;
+	i2c_as_ptr    = i2c_q_wr_len;
+	i2c_as_ptr   += i2c_q_index;
+	i2c_as_wr_len = *i2c_as_ptr;
+	i2c_as_ptr    = i2c_q_rd_ptr;
+	i2c_as_ptr   += i2c_q_index;
+	i2c_as_rd_ptr = *i2c_as_ptr;
+	i2c_as_ptr    = i2c_q_rd_len;
+	i2c_as_ptr   += i2c_q_index;
+	i2c_as_rd_len = *i2c_as_ptr;
+}
+
+
+// Address byte after a start. Read address once all bytes are written.
+static void I2C_As_Address (void)
+{
+	i2c_as_shift   = (i2c_as_addr << 1) | I2C_WR_CMD;
+	i2c_as_reading = 0;
+	if (!i2c_as_wr_len && i2c_as_rd_len)
+	{
+		i2c_as_shift   = (i2c_as_addr << 1) | I2C_RD_CMD;
+		i2c_as_reading = 1;
+	}
+
+	i2c_as_state = I2C_AS_TX;
+	i2c_as_step  = 0;
+	i2c_as_phase = 0;
+}
+
+
+// Byte and its ack are clocked out, SCL is high
+static void I2C_As_Tx_Done (void)
+{
+	i2c_as_step = 0;
+
+	if (I2C_SDA)
+	{
+		i2c_async_nack |= i2c_as_mask;
+		i2c_as_state    = I2C_AS_STOP;
+	}
+	else if (i2c_as_reading) i2c_as_state = I2C_AS_RX;
+	else if (i2c_as_wr_len)
+	{
+		i2c_as_ptr    = 0;
+		i2c_as_ptr$0  = i2c_as_wr_ptr;
+		i2c_as_shift  = *i2c_as_ptr;
+		i2c_as_wr_ptr++;
+		i2c_as_wr_len--;
+	}
+	else if (i2c_as_rd_len) i2c_as_state = I2C_AS_RESTART;
+	else                    i2c_as_state = I2C_AS_STOP;
+}
+
+
+// Byte is clocked in and acked, SCL is high
+static void I2C_As_Rx_Done (void)
+{
+	i2c_as_step  = 0;
+	i2c_as_ptr   = 0;
+	i2c_as_ptr$0 = i2c_as_rd_ptr;
+	*i2c_as_ptr  = i2c_as_shift;
+	i2c_as_rd_ptr++;
+	i2c_as_rd_len--;
+	if (!i2c_as_rd_len) i2c_as_state = I2C_AS_STOP;
+}
+
+
+// Stop condition is on the bus. Retire the head slot.
+static void I2C_As_Done (void)
+{
+	i2c_async_done |= i2c_as_mask;
+
+	i2c_q_head++;
+	if (i2c_q_head == I2C_QUEUE) i2c_q_head = 0;
+	i2c_q_count--;
+
+	i2c_as_state = I2C_AS_IDLE;
+}
+
+#ENDIF
+
+
 //===================//
 // PROGRAM INTERFACE //
 //===================//
@@ -171,6 +435,19 @@ void I2C_Initialize (void)
 		$ I2C_SDA	In, Pull;       // Set data input pull high register
 		$ I2C_SDA	Out, High;      // Set data input to output high
 		$ I2C_SCL	Out, High;      // Clock pin set output high
+
+		#IF I2C_ASYNC
+			$ I2C_TIMER_CTL STOP;
+			I2C_TIMER_BND  = I2C_ASYNC_BND;
+			I2C_TIMER_SCL  = I2C_TIMER_DIV;
+			i2c_as_state   = I2C_AS_IDLE;
+			i2c_q_head     = 0;
+			i2c_q_count    = 0;
+			i2c_async_busy = 0;
+			INTRQ.I2C_INTR = 0;             // Ensure that timer interrupt is cleared
+			INTEN.I2C_INTR = 1;             // Enable timer interrupt
+		#ENDIF
+
 		i2c_module_initialized = 1; // Enable I2C functions
 	}
 	i2c_num_initializations++;      // Count number of initializations
@@ -184,6 +461,12 @@ void I2C_Release (void)
 		i2c_num_initializations--;      // Count remaining initializations
 		if (! i2c_num_initializations)   // If none remaining
 		{
+			#IF I2C_ASYNC
+				$ I2C_TIMER_CTL STOP;
+				INTEN.I2C_INTR = 0;
+				i2c_async_busy = 0;
+			#ENDIF
+
 			$ I2C_SCL	In, NoPull;     // Set clock to low power
 			$ I2C_SDA	In, NoPull;     // Set data to low power
 			i2c_module_initialized = 0; // Disable I2C functions
@@ -244,9 +527,220 @@ void I2C_Stream_Read_Byte_NAck (void)
 }
 
 
+void I2C_Stream_Restart (void)
+{
+	if (i2c_module_initialized)
+	{
+		I2C_Restart();                                // I2C repeated start condition
+		i2c_buffer = (i2c_device << 1) | I2C_RD_CMD; // Transfer device addr + RD bit to buffer
+		I2C_Stream_Write_Byte();                      // Transmit buffer
+	}
+}
+
+
 void I2C_Stream_Stop (void)
 {
 	if (i2c_module_initialized) I2C_Stop(); // I2C stop condition
 }
 
+
+// Write i2c_wr_len bytes from i2c_wr_ptr after a write address.
+// Ends at the first slave nack, the address included. The bytes
+// left are in i2c_wr_len.
+void I2C_Write_Block (void)
+{
+	if (i2c_module_initialized)
+	{
+		while (i2c_wr_len)
+		{
+			if (i2c_slave_ack_bit) break;
+			i2c_buffer = *i2c_wr_ptr;
+			I2C_Tx_ACC();
+			I2C_Listen_Ack();
+			i2c_wr_ptr++;
+			i2c_wr_len--;
+		}
+	}
+}
+
+
+// Read i2c_rd_len bytes into i2c_rd_ptr after a read address.
+// Each byte is acked but the last, which is nacked.
+void I2C_Read_Block (void)
+{
+	if (i2c_module_initialized && i2c_rd_len)
+	{
+		while (--i2c_rd_len)
+		{
+			I2C_Read();
+			I2C_Provide_Ack();
+			*i2c_rd_ptr = i2c_buffer;
+			i2c_rd_ptr++;
+		}
+		I2C_Read();
+		I2C_Provide_NAck();
+		*i2c_rd_ptr = i2c_buffer;
+	}
+}
+
+
+// Write i2c_wr_len bytes from i2c_wr_ptr, then read i2c_rd_len bytes to
+// i2c_rd_ptr after a repeated start. Either length may be 0.
+void I2C_Write_Read (void)
+{
+	if (i2c_module_initialized)
+	{
+		if (!i2c_wr_len && i2c_rd_len) I2C_Stream_Read_Start();
+		else
+		{
+			I2C_Stream_Write_Start();
+			I2C_Write_Block();
+			if (i2c_slave_ack_bit) i2c_rd_len = 0;  // Slave nack, skip to stop
+			if (i2c_rd_len) I2C_Stream_Restart();
+		}
+
+		if (i2c_slave_ack_bit) i2c_rd_len = 0;  // Read address nack
+		I2C_Read_Block();
+		I2C_Stream_Stop();
+	}
+}
+
+
+#IF I2C_ASYNC
+
+// Queue i2c_device, i2c_wr_ptr/len and i2c_rd_ptr/len. Slot in i2c_async_slot.
+void I2C_Async_Submit (void)
+{
+	i2c_async_slot = 0xFF;
+
+	if (i2c_module_initialized && (i2c_q_count < I2C_QUEUE))
+	{
+		// Hold off the engine, the global enable is left alone
+		i2c_q_inten = INTEN;
+		INTEN = 0;
+
+		i2c_q_index  = i2c_q_head;
+		i2c_q_index += i2c_q_count;
+		if (i2c_q_index >= I2C_QUEUE) i2c_q_index -= I2C_QUEUE;
+
+		i2c_as_ptr    = i2c_q_addr;
+		i2c_as_ptr   += i2c_q_index;
+		*i2c_as_ptr   = i2c_device;
+		i2c_as_ptr    = i2c_q_wr_ptr;
+		i2c_as_ptr   += i2c_q_index;
+		*i2c_as_ptr   = i2c_wr_ptr$0;
+		i2c_as_ptr    = i2c_q_wr_len;
+		i2c_as_ptr   += i2c_q_index;
+		*i2c_as_ptr   = i2c_wr_len;
+		i2c_as_ptr    = i2c_q_rd_ptr;
+		i2c_as_ptr   += i2c_q_index;
+		*i2c_as_ptr   = i2c_rd_ptr$0;
+		i2c_as_ptr    = i2c_q_rd_len;
+		i2c_as_ptr   += i2c_q_index;
+		*i2c_as_ptr   = i2c_rd_len;
+
+		i2c_async_slot  = i2c_q_index;
+		i2c_q_count++;
+
+		// Drop stale status of this slot
+		I2C_Slot_Mask();
+		i2c_async_done &= ~i2c_q_mask;
+		i2c_async_nack &= ~i2c_q_mask;
+
+		if (!i2c_async_busy)
+		{
+			i2c_async_busy = 1;
+			I2C_TIMER_CNT  = 0;
+			$ I2C_TIMER_CTL I2C_TIMER_CLK;
+		}
+
+		INTEN = i2c_q_inten;
+	}
+}
+
+
+// INTERRUPT
+// One half bit per tick. Data changes while SCL is low and is sampled
+// while SCL is high.
+void I2C_Async_Interrupt (void)
+{
+	if (i2c_as_state == I2C_AS_IDLE)
+	{
+		// Bus has been free for at least one tick
+		if (i2c_q_count)
+		{
+			I2C_As_Load();
+			i2c_as_state = I2C_AS_START;
+		}
+		else
+		{
+			$ I2C_TIMER_CTL STOP;
+			i2c_async_busy = 0;
+		}
+	}
+	else if (i2c_as_state == I2C_AS_START)
+	{
+		$ I2C_SDA Out, Low;
+		I2C_As_Address();
+	}
+	else if (i2c_as_state == I2C_AS_TX)
+	{
+		if (!i2c_as_phase)
+		{
+			$ I2C_SCL Low;
+			if (i2c_as_step == 8)      $ I2C_SDA In;	// Slave ack
+			else if (i2c_as_shift.7)   $ I2C_SDA Out, High;
+			else                       $ I2C_SDA Out, Low;
+			i2c_as_shift <<= 1;
+			i2c_as_phase   = 1;
+		}
+		else
+		{
+			$ I2C_SCL High;
+			i2c_as_phase = 0;
+			if (i2c_as_step == 8) I2C_As_Tx_Done();
+			else i2c_as_step++;
+		}
+	}
+	else if (i2c_as_state == I2C_AS_RX)
+	{
+		if (!i2c_as_phase)
+		{
+			$ I2C_SCL Low;
+			if (i2c_as_step != 8)      $ I2C_SDA In;
+			else if (i2c_as_rd_len == 1) $ I2C_SDA Out, High;	// NAck the last byte
+			else                       $ I2C_SDA Out, Low;	// Ack
+			i2c_as_phase = 1;
+		}
+		else
+		{
+			$ I2C_SCL High;
+			i2c_as_phase = 0;
+			if (i2c_as_step == 8) I2C_As_Rx_Done();
+			else
+			{
+				i2c_as_shift <<= 1;
+				if (I2C_SDA) i2c_as_shift.0 = 1;
+				i2c_as_step++;
+			}
+		}
+	}
+	else if (i2c_as_state == I2C_AS_RESTART)
+	{
+		if      (i2c_as_step == 0) { $ I2C_SCL Low; $ I2C_SDA Out, High; i2c_as_step = 1; }
+		else if (i2c_as_step == 1) { $ I2C_SCL High; i2c_as_step = 2; }
+		else                       { $ I2C_SDA Out, Low; I2C_As_Address(); }
+	}
+	else // I2C_AS_STOP
+	{
+		if      (i2c_as_step == 0) { $ I2C_SCL Low; $ I2C_SDA Out, Low; i2c_as_step = 1; }
+		else if (i2c_as_step == 1) { $ I2C_SCL High; i2c_as_step = 2; }
+		else                       { $ I2C_SDA Out, High; I2C_As_Done(); }
+	}
+
+	INTRQ.I2C_INTR = 0;					// Clear timer interrupt flag
+}
+
+#ENDIF
+
 #ENDIF // PERIPH_I2C
@@ -4,8 +4,25 @@ I2C declarations based off of the PADAUK IDE v0.91 Code Generator.
 Define PERIPH_I2C in system_settings.h
 
 In the communication protocol provided here, the MSB is Tx/Rx first.
-Timings are configured for 100kHz with system_settings.h. Higher may
-be achievable, but it is currently untested.
+
+I2C_Write_Read writes i2c_wr_len bytes from i2c_wr_ptr, then reads
+i2c_rd_len bytes into i2c_rd_ptr after a repeated start, in one
+transaction. I2C_Stream_Restart sends the repeated start and the read
+address within a streamed write.
+
+I2C_Write_Block and I2C_Read_Block move a whole buffer after a start or
+restart, without the per-byte call and checks of the stream functions.
+Write ends at a slave nack. Read acks each byte and nacks the last.
+I2C_SPEED in system_settings.h selects 100kHz, 400kHz or 1MHz minimum
+bus times. Gaps between bytes run the bus somewhat slower, see pdk_i2c.c.
+
+ASYNC: With I2C_ASYNC set, fill i2c_device, i2c_wr_ptr/len and
+i2c_rd_ptr/len, then call I2C_Async_Submit. i2c_async_slot holds the
+queue slot (0xFF if full); poll that bit in i2c_async_done and check it
+in i2c_async_nack. A write followed by a read uses a repeated start.
+Call I2C_Async_Interrupt from the Interrupt function on I2C_INTR.
+The engine holds the CPU for at most one tick, but costs about twice
+the CPU time of the stream functions, see COST in pdk_i2c.c.
 
 ROM Consumed : 197B / 0xC5
 RAM Consumed :  12B / 0x0C
@@ -28,6 +45,15 @@ EXTERN BYTE i2c_device;	       // Device address.
 EXTERN BYTE i2c_buffer;	       // Pointer to Tx/Rx byte.
 EXTERN BIT  i2c_slave_ack_bit; // Slave acknowledge bit.
 
+EXTERN WORD i2c_wr_ptr;        // Bytes to write
+EXTERN WORD i2c_rd_ptr;        // Buffer for read bytes
+EXTERN BYTE i2c_wr_len;
+EXTERN BYTE i2c_rd_len;
+EXTERN BYTE i2c_async_slot;    // I2C_ASYNC only. Slot of last submit
+EXTERN BYTE i2c_async_done;    // I2C_ASYNC only. Bit per slot
+EXTERN BYTE i2c_async_nack;    // I2C_ASYNC only. Bit per slot
+EXTERN BIT  i2c_async_busy;    // I2C_ASYNC only
+
 
 //===================//
 // PROGRAM INTERFACE //
@@ -40,4 +66,10 @@ void I2C_Stream_Read_Start     (void);
 void I2C_Stream_Write_Byte     (void);
 void I2C_Stream_Read_Byte_Ack  (void);
 void I2C_Stream_Read_Byte_NAck (void);
+void I2C_Stream_Restart        (void); // Repeated start + read address
 void I2C_Stream_Stop           (void);
+void I2C_Write_Block           (void); // i2c_wr_xxx, ends on nack
+void I2C_Read_Block            (void); // i2c_rd_xxx, nack on last byte
+void I2C_Write_Read            (void); // i2c_wr_xxx, restart, i2c_rd_xxx
+void I2C_Async_Submit          (void); // I2C_ASYNC only
+void I2C_Async_Interrupt       (void); // I2C_ASYNC only
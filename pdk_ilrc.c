@@ -0,0 +1,80 @@
+/* pdk_ilrc.c
+
+ILRC calibration. Measures the ILRC clock against SYSCLK with T16 and keeps
+the result in ilrc_hz. Define PERIPH_ILRC in system_settings.h
+
+ROM Consumed : 28B / 0x1C
+RAM Consumed :  6B / 0x06
+
+
+NOTE:
+
+	ILRC_HZ in system_settings.h is a typical value. The real clock moves
+	with supply voltage and temperature, and the ICE runs near ICE_ILRC_HZ.
+	ILRC_Calibrate counts ILRC edges on T16 for a window timed by SYSCLK,
+	so the result is as good as SYSCLK. IHRC based SYSCLK is factory
+	trimmed, so expect roughly 1% or better.
+
+	Call ILRC_Calibrate at startup, and again on demand, e.g. after a
+	supply or temperature change. The window is 1 / 2^ILRC_CAL_SHIFT s
+	and INTEN is cleared for it, then restored. Global interrupts are
+	left as the caller had them, so it is safe before the program sets
+	them up. T16 is stopped on return, so do not calibrate while T16 is
+	used elsewhere.
+
+	Users of ilrc_hz:
+		Timer8 solvers   : Timers clocked by ILRC use ilrc_hz instead of
+		                   TIMER8_x_HZ. Build time targets keep ILRC_HZ.
+		Button debouncer : Button_Update_Timing recomputes the bound.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+#include "system_settings.h"
+
+#IF PERIPH_ILRC
+
+//======================//
+// VARIABLES AND MACROS //
+//======================//
+
+EWORD ilrc_hz = ILRC_HZ;
+
+STATIC WORD ilrc_count;
+STATIC BYTE ilrc_inten;		// Caller's INTEN during the window
+
+
+// Instruction cycles in the 1 / 2^ILRC_CAL_SHIFT s window
+ILRC_WINDOW   =>  SYSTEM_CLOCK / INSTR_CYCLES >> ILRC_CAL_SHIFT;
+
+
+//===================//
+// PROGRAM FUNCTIONS //
+//===================//
+
+
+// CALIBRATE
+void ILRC_Calibrate(void)
+{
+	ilrc_count = 0;
+
+	ilrc_inten = INTEN;						// Interrupts would stretch the window
+	INTEN = 0;
+	stt16 ilrc_count;
+	$ T16M ILRC, /1, BIT15;
+	.delay ILRC_WINDOW;
+	$ T16M STOP;
+	INTEN = ilrc_inten;						// Requests raised meanwhile are still pending
+
+	ldt16 ilrc_count;
+	ilrc_hz = ilrc_count;
+	ilrc_hz <<= ILRC_CAL_SHIFT;
+}
+
+#ENDIF // PERIPH_ILRC
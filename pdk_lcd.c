@@ -5,6 +5,11 @@ LCD definitions for Padauk microcontrollers.
 ROM Consumed : 221B / 0xDD
 RAM Consumed :  11B / 0x0B
 
+With LCD_USE_SWT, the 40ms clear and the 40ms / 200ms power up waits run on
+software timer SWT_ID_LCD instead of .delay. LCD_Initialize and LCD_Clear
+return at once with lcd_busy set. Call LCD_Poll from the main loop. The LCD
+is ready when lcd_busy clears. Writes made while busy wait for the timer.
+
 
 This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
 Any modifications or distributions have to be licensed under GPLv3.
@@ -18,6 +23,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 
 #IF PERIPH_LCD
 #include "pdk_i2c.h"
+#if LCD_USE_SWT
+	#include "pdk_swtimer.h"
+#endif
 
 //===========//
 // VARIABLES //
@@ -28,6 +36,11 @@ BYTE	lcd_trx_byte;
 BYTE	lcd_flags = 0;
 BIT     lcd_command  : lcd_flags.?;
 BIT		lcd_module_initialized : lcd_flags.?;
+BIT		lcd_busy : lcd_flags.?;				// Software timer wait in progress
+
+#if LCD_USE_SWT
+	STATIC BYTE lcd_init_step = 0;		// Power up step waiting on the timer, 0: none
+#endif
 
 
 LCD_Init_Delay =>   LCD_INIT_D
@@ -56,9 +69,10 @@ void	LCD_Read_Command(void)
 {
 	#ifidni LCD_COMM_MODE, I2C
 		i2c_device = lcd_device_addr;
-		I2C_Stream_Read_Start();
+		I2C_Stream_Write_Start();
 		i2c_buffer = LCD_COMMAND_MODE;
 		I2C_Stream_Write_Byte();
+		I2C_Stream_Restart();
 		I2C_Stream_Read_Byte_NAck();
 		lcd_trx_byte = i2c_buffer;
 		I2C_Stream_Stop();
@@ -82,10 +96,11 @@ void	LCD_Read_Data(void)
 {                
 	#ifidni LCD_COMM_MODE, I2C
 		i2c_device = lcd_device_addr;
-		I2C_Stream_Read_Start();
+		I2C_Stream_Write_Start();
 		i2c_buffer = LCD_DATA_MODE;
 		I2C_Stream_Write_Byte();
-		I2C_Stream_Read_Byte_Nack();
+		I2C_Stream_Restart();
+		I2C_Stream_Read_Byte_NAck();
 		lcd_trx_byte = i2c_buffer;
 		I2C_Stream_Stop();
 	#endif
@@ -99,8 +114,80 @@ void	LCD_Check_Busy (void)
 }
 
 
+#if LCD_USE_SWT
+void	LCD_Poll (void);
+
+
+// Start a software timer wait of swt_ticks
+void	LCD_Wait_Ticks (void)
+{
+	swt_id     = SWT_ID_LCD;
+	swt_period = 0;
+	SWT_Start();
+	lcd_busy   = 1;
+}
+#endif
+
+
+// Power up command groups, separated by the long waits
+void	LCD_Init_Sequence_1 (void)
+{
+	#ifidni %LCD_DRIVER, ST7032
+		lcd_trx_byte = LCD_INIT_FUNC1;
+		LCD_Write_Command();
+		.delay(LCD_Wait_Delay);
+
+		lcd_trx_byte = LCD_INIT_FUNC2;
+		LCD_Write_Command();
+		.delay(LCD_Wait_Delay);
+
+		lcd_trx_byte = LCD_INIT_BIAS_OSC;
+		LCD_Write_Command();
+		.delay(LCD_Wait_Delay);
+
+		lcd_trx_byte = LCD_INIT_CONTRASTL;
+		LCD_Write_Command();
+		.delay(LCD_Wait_Delay);
+
+		lcd_trx_byte = LCD_INIT_PWR_ICON_CNTRSTH;
+		LCD_Write_Command();
+		.delay(LCD_Wait_Delay);
+
+		lcd_trx_byte = LCD_INIT_FOLLOWER;
+		LCD_Write_Command();
+	#endif
+}
+
+
+void	LCD_Init_Sequence_2 (void)
+{
+	#ifidni %LCD_DRIVER, ST7032
+		lcd_trx_byte = (LCD_DISP_F | LCD_DISP_ON);
+		LCD_Write_Command();
+		.delay(LCD_Wait_Delay);
+
+		lcd_trx_byte = (LCD_CLEAR_F);
+		LCD_Write_Command();
+	#endif
+}
+
+
+void	LCD_Init_Sequence_3 (void)
+{
+	#ifidni %LCD_DRIVER, ST7032
+		lcd_trx_byte = (LCD_ENTRY_F | LCD_ENTRY_INC_DDRAM);
+		LCD_Write_Command();
+		.delay(LCD_Wait_Delay)
+	#endif
+}
+
+
 void	LCD_Delay_While_Busy (void)
 {
+	#if LCD_USE_SWT
+		while (lcd_busy) LCD_Poll();
+	#endif
+
 	#ifdifi %LCD_DRIVER, ST7032
 		do LCD_Check_Busy();
 		while (lcd_trx_byte && lcd_detected);
@@ -147,7 +234,12 @@ void	LCD_Clear		(void)
 		lcd_command = 1;
 		lcd_trx_byte = (LCD_CLEAR_F);
 		LCD_Write_Byte();
-		.delay LCD_Init_Delay;
+		#if LCD_USE_SWT
+			swt_ticks = LCD_INIT_TICKS;
+			LCD_Wait_Ticks();
+		#else
+			.delay LCD_Init_Delay;
+		#endif
 	}
 }
 
@@ -232,54 +324,69 @@ void	LCD_Initialize	(void)
 {
 	if ( !lcd_module_initialized)
 	{
-		.delay(LCD_Init_Delay);
-
-		#ifidni LCD_COMM_MODE, I2C
-			I2C_Initialize();
-		#endif
-
-		#ifidni %LCD_DRIVER, ST7032
-			lcd_trx_byte = LCD_INIT_FUNC1;
-			LCD_Write_Command();
-			.delay(LCD_Wait_Delay);
-
-			lcd_trx_byte = LCD_INIT_FUNC2;
-			LCD_Write_Command();
-			.delay(LCD_Wait_Delay);
-	
-			lcd_trx_byte = LCD_INIT_BIAS_OSC;
-			LCD_Write_Command();
-			.delay(LCD_Wait_Delay);
-
-			lcd_trx_byte = LCD_INIT_CONTRASTL;
-			LCD_Write_Command();
-			.delay(LCD_Wait_Delay);
-	
-			lcd_trx_byte = LCD_INIT_PWR_ICON_CNTRSTH;
-			LCD_Write_Command();
-			.delay(LCD_Wait_Delay);
-
-			lcd_trx_byte = LCD_INIT_FOLLOWER;
-			LCD_Write_Command();
+		#if LCD_USE_SWT
+			if (!lcd_init_step)
+			{
+				#ifidni LCD_COMM_MODE, I2C
+					I2C_Initialize();
+				#endif
+
+				// Rest of the sequence runs from LCD_Poll
+				lcd_init_step = 1;
+				swt_ticks = LCD_INIT_TICKS;
+				LCD_Wait_Ticks();
+			}
+		#else
+			.delay(LCD_Init_Delay);
+
+			#ifidni LCD_COMM_MODE, I2C
+				I2C_Initialize();
+			#endif
+
+			LCD_Init_Sequence_1();
 			.delay(LCD_Pwr_Delay);
-
-			lcd_trx_byte = (LCD_DISP_F | LCD_DISP_ON);
-			LCD_Write_Command();
-			.delay(LCD_Wait_Delay);
-
-			lcd_trx_byte = (LCD_CLEAR_F);
-			LCD_Write_Command();
+			LCD_Init_Sequence_2();
 			.delay(LCD_Init_Delay)
+			LCD_Init_Sequence_3();
 
-			lcd_trx_byte = (LCD_ENTRY_F | LCD_ENTRY_INC_DDRAM);
-			LCD_Write_Command();
-			.delay(LCD_Wait_Delay)
-
+			lcd_module_initialized = 1;
 		#endif
+	}
+}
+
+
+#if LCD_USE_SWT
+// Finish software timer waits and step the power up sequence. Call from the main loop.
+void	LCD_Poll		(void)
+{
+	if (lcd_busy && swt_expired.SWT_ID_LCD)
+	{
+		swt_expired.SWT_ID_LCD = 0;
+		lcd_busy = 0;
 
-		lcd_module_initialized = 1;
+		if (lcd_init_step == 1)
+		{
+			LCD_Init_Sequence_1();
+			lcd_init_step = 2;
+			swt_ticks = LCD_PWR_TICKS;
+			LCD_Wait_Ticks();
+		}
+		else if (lcd_init_step == 2)
+		{
+			LCD_Init_Sequence_2();
+			lcd_init_step = 3;
+			swt_ticks = LCD_INIT_TICKS;
+			LCD_Wait_Ticks();
+		}
+		else if (lcd_init_step == 3)
+		{
+			LCD_Init_Sequence_3();
+			lcd_init_step = 0;
+			lcd_module_initialized = 1;
+		}
 	}
 }
+#endif
 
 
 void	LCD_Release		(void)
@@ -289,6 +396,13 @@ void	LCD_Release		(void)
 		I2C_Release();
 		lcd_module_initialized = 0;
 	}
+
+	#if LCD_USE_SWT
+		swt_id = SWT_ID_LCD;
+		SWT_Stop();
+		lcd_busy = 0;
+		lcd_init_step = 0;
+	#endif
 }
 
 #ENDIF // PERIPH_LCD
@@ -22,6 +22,7 @@ Copyright (c) 2021 Robert R. Puccinelli
 EXTERN BYTE lcd_device_addr;
 EXTERN BYTE lcd_trx_byte;
 EXTERN BIT  lcd_command;
+EXTERN BIT  lcd_busy;        // LCD_USE_SWT only. Wait in progress, see LCD_Poll
 
 
 //===================//
@@ -33,6 +34,7 @@ void LCD_Initialize       (void);
 void LCD_Release          (void);
 void LCD_Read_Byte        (void);
 void LCD_Write_Byte       (void);
+void LCD_Poll             (void);   // LCD_USE_SWT only, call from main loop
 
 // LCD Function Control
 void LCD_Clear            (void);
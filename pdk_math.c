@@ -2,26 +2,73 @@
 
 Basic multiplication and division functions.
 
-ROM Consumed : 284B / 0x11C
-RAM Consumed : 11B  / 0x0B
+ROM Consumed : 818B / 0x332  -  1090B / 0x442 WITH MULTIPLIER
+RAM Consumed : 17B  / 0x11
 
 
 NOTE:
 
-	Function maximum run time @ 4 MHz
+	Function maximum run time @ 4 MHz. Worst cases from tools/math_model.cpp,
+	which estimates cycles per statement at 4 cycles per us. Rows marked *
+	are not in the model and are hand counts from the code.
 
-	byte_divide   28  us
-	word_divide   92  us
-	eword_divide  148 us
-	dword_divide  204 us
+	byte_divide   29  us
+	word_divide   93  us
+	eword_divide  143 us
+	dword_divide  208 us
+	Eword_Divide_Const 70 us WITH MULTIPLIER, 150 us otherwise
 
-	byte_multiply 30  us  3 us WITH MULTIPLIER
-	word_multiply 62  us  9 us WITH MULTIPLIER 
+	eword_divide and dword_divide skip leading zero bytes of the dividend,
+	so run time scales with the dividend width instead of the type width.
+
+	Dividend width  8b      16b     24b     32b
+	eword_divide    61 us   102 us  143 us  -
+	dword_divide    71 us   118 us  165 us  208 us
+
+	byte_multiply  39  us  4  us WITH MULTIPLIER
+	word_multiply  79  us  18 us WITH MULTIPLIER
+	eword_multiply 161 us  45 us WITH MULTIPLIER
+	dword_multiply 206 us  52 us WITH MULTIPLIER
+
+	word_sqrt       94  us
+	dword_sqrt      181 us
+	word_reciprocal 407 us  167 us WITH MULTIPLIER
+	ppm_error       270 us  215 us WITH MULTIPLIER *
+
+	byte_to_bcd     66  us
+	word_to_bcd     152 us
+	eword_to_bcd    260 us
+	dword_to_bcd    386 us
+	bcd_unpack      92  us  10 digits
+
+	mac_8x8         42  us  11 us WITH MULTIPLIER *
+	mac_16x8        40  us  10 us WITH MULTIPLIER *
+	fir_filter      +45 us  +14 us WITH MULTIPLIER, per tap *
+
+	math_isr_save    9 us  10 us WITH MULTIPLIER *
+	math_isr_restore 9 us  11 us WITH MULTIPLIER *
+
+
+ISR CONTEXT:
+
+	All routines share one static scratch block. An interrupt that does math
+	would corrupt a routine running in the main loop. Set MATH_ISR_SAVE in
+	system_settings.h and bracket the interrupt math with:
+
+		pushaf;
+		math_isr_save();
+		...
+		math_isr_restore();
+		popaf;
+
+	The shadow block costs +17B RAM (+19B WITH MULTIPLIER) and ~40B ROM.
 
 	Division framework sourced from Wikipedia Division Algorithm, Long Div.
 	Div was made more efficient by having quotient and dividend share memory.
 	Multiplication framework (non-mulop) duplicated from Padauk Code Gen
 	Multiplication framework (mulop) developed from experience
+	Constant division from Granlund & Montgomery, Division by Invariant Integers
+	Square root is the digit-by-digit method, 2 radicand bits per root bit
 
 
 This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
@@ -41,9 +88,22 @@ Copyright (c) 2021 Robert R. Puccinelli
 //===========//
 
 STATIC BYTE  math_byte1;
-STATIC EWORD math_eword1;
-STATIC EWORD math_eword2;
 STATIC DWORD math_dword1;
+STATIC DWORD math_dword2;
+STATIC DWORD math_dword3;
+STATIC DWORD math_dword4;
+
+#IF MATH_ISR_SAVE
+STATIC BYTE  math_byte1_isr;
+STATIC DWORD math_dword1_isr;
+STATIC DWORD math_dword2_isr;
+STATIC DWORD math_dword3_isr;
+STATIC DWORD math_dword4_isr;
+#IF HAS_MULTIPLIER
+STATIC BYTE  math_mulop_isr;
+STATIC BYTE  math_mulrh_isr;
+#ENDIF
+#ENDIF
 
 
 //==================//
@@ -52,15 +112,164 @@ STATIC DWORD math_dword1;
 
 
 DWORD &math_dividend  = math_dword1$0;
-EWORD &math_divisor   = math_eword1$0;
-EWORD &math_remainder = math_eword2$0;
+EWORD &math_divisor   = math_dword3$0;
+EWORD &math_remainder = math_dword4$0;
 DWORD &math_quotient  = math_dividend$0;
 
-WORD &math_mult_a     = math_eword1$0;
-WORD &math_mult_b     = math_eword2$0;
+WORD  &math_mult_a    = math_dword3$0;
+WORD  &math_mult_b    = math_dword4$0;
+DWORD &math_mult_da   = math_dword3$0;
+DWORD &math_mult_db   = math_dword4$0;
 DWORD &math_product   = math_dword1$0;
+DWORD &math_product_h = math_dword2$0;
 
+WORD  &math_root      = math_dword2$0;
+
+DWORD &math_bcd       = math_dword2$0;
+BYTE  &math_bcd_h     = math_dword3$0;
+WORD  &math_bcd_ptr   = math_dword1$0;
+
+DWORD &math_mac_acc   = math_dword2$0;
+WORD  &math_mac_x     = math_dword3$0;
+BYTE  &math_mac_c     = math_dword4$0;
+WORD  &math_fir_ptr   = math_dword4$2;
+
+BYTE  &math_shift      = math_byte1$0;
 STATIC BYTE &counter = math_byte1$0;
+STATIC BYTE &product_x = math_byte1$0;
+
+STATIC WORD &product_hi  = math_dword1$2;
+STATIC WORD &recip_xn    = math_dword2$0;
+STATIC WORD &recip_r     = math_dword2$2;
+STATIC BYTE &recip_shift = math_dword3$2;
+STATIC BYTE &bcd_digit   = math_dword4$0;
+STATIC BYTE &bcd_count   = math_dword3$1;
+STATIC BYTE &mac_sign    = math_dword4$1;
+
+
+//========//
+// MACROS //
+//========//
+
+// Shift the 64-bit product down a byte. product_x becomes the top byte.
+Product_Shift_Byte	macro
+	math_product$0   = math_product$1;
+	math_product$1   = math_product$2;
+	math_product$2   = math_product$3;
+	math_product$3   = math_product_h$0;
+	math_product_h$0 = math_product_h$1;
+	math_product_h$1 = math_product_h$2;
+	math_product_h$2 = math_product_h$3;
+	math_product_h$3 = product_x;
+	product_x        = 0;
+	endm
+
+
+#IF HAS_MULTIPLIER
+
+// Add math_dividend byte x magic number into the accumulator and drop its low byte
+Magic_Row	macro	xb
+	mulop = xb;
+	A = math_divisor$0;
+	mul;
+	math_dword2 += A;
+	math_dword2 += (mulrh << 8);
+
+	A = math_divisor$1;
+	mul;
+	math_dword2 += (A << 8);
+	math_dword2 += (mulrh << 16);
+
+	A = math_divisor$2;
+	mul;
+	math_dword2 += (A << 16);
+	math_dword2 += (mulrh << 24);
+
+	math_dword2$0 = math_dword2$1;
+	math_dword2$1 = math_dword2$2;
+	math_dword2$2 = math_dword2$3;
+	math_dword2$3 = 0;
+	endm
+
+
+// Add math_mult_db x byte into the upper product and shift the product down a byte
+Product_Row	macro	ab
+	mulop = ab;
+	A = math_mult_db$0;
+	mul;
+	math_product_h$0 += A;
+	A = mulrh;
+	addc A;
+	math_product_h$1 += A;
+	addc math_product_h$2;
+	addc math_product_h$3;
+	addc product_x;
+
+	A = math_mult_db$1;
+	mul;
+	math_product_h$1 += A;
+	A = mulrh;
+	addc A;
+	math_product_h$2 += A;
+	addc math_product_h$3;
+	addc product_x;
+
+	A = math_mult_db$2;
+	mul;
+	math_product_h$2 += A;
+	A = mulrh;
+	addc A;
+	math_product_h$3 += A;
+	addc product_x;
+
+	A = math_mult_db$3;
+	mul;
+	math_product_h$3 += A;
+	A = mulrh;
+	addc A;
+	product_x += A;
+
+	Product_Shift_Byte ();
+	endm
+
+#ENDIF
+
+
+// Double dabble correction. Digits >= 5 get +3 so the next shift carries into the next digit.
+BCD_Adjust	macro	b
+	if (b)
+	{
+		if ((b & 0x0F) >= 0x05) b += 0x03;
+		if (b >= 0x50) b += 0x30;
+	}
+	endm
+
+
+// Shift the 10 digit packed BCD result left one bit through carry
+BCD_Shift	macro
+	slc math_bcd$0;
+	slc math_bcd$1;
+	slc math_bcd$2;
+	slc math_bcd$3;
+	slc math_bcd_h;
+	endm
+
+
+// Add math_mult_db into the upper product if the shifted out bit was set,
+// then shift the 64-bit product right through carry.
+Product_Shift_Add	macro
+	math_mult_da >>= 1;
+	if (CF) math_product_h += math_mult_db;
+	src math_product_h$3;
+	src math_product_h$2;
+	src math_product_h$1;
+	src math_product_h$0;
+	src math_product$3;
+	src math_product$2;
+	src math_product$1;
+	src math_product$0;
+	endm
+
 
 //===================//
 // PROGRAM FUNCTIONS //
@@ -134,6 +343,15 @@ void eword_divide(void)
 	}
 	else
 	{
+		// Leading zero bytes cannot set quotient bits. Skip them 8 iterations at a time.
+		while (!math_dividend$2 && (counter > 8))
+		{
+			math_dividend$2 = math_dividend$1;
+			math_dividend$1 = math_dividend$0;
+			math_dividend$0 = 0;
+			counter -= 8;
+		}
+
 		do 
 		{
 			sl  math_dividend$0;
@@ -165,6 +383,16 @@ void dword_divide(void)
 	}
 	else
 	{
+		// Leading zero bytes cannot set quotient bits. Skip them 8 iterations at a time.
+		while (!math_dividend$3 && (counter > 8))
+		{
+			math_dividend$3 = math_dividend$2;
+			math_dividend$2 = math_dividend$1;
+			math_dividend$1 = math_dividend$0;
+			math_dividend$0 = 0;
+			counter -= 8;
+		}
+
 		do 
 		{
 			sl  math_dividend$0;
@@ -176,7 +404,14 @@ void dword_divide(void)
 			slc math_remainder$1;
 			slc math_remainder$2;
 
-			if (math_remainder >= math_divisor)
+			// A bit out of the top puts the remainder past 2^24, above any
+			// divisor. The 24-bit subtract still leaves the right remainder.
+			if (CF)
+			{
+				math_remainder -= math_divisor;
+				math_quotient |= 0b1;
+			}
+			else if (math_remainder >= math_divisor)
 			{
 				math_remainder -= math_divisor;
 				math_quotient |= 0b1;
@@ -186,6 +421,41 @@ void dword_divide(void)
 	}
 }
 
+#IF HAS_MULTIPLIER
+
+// Called through Eword_Divide_Const. math_dividend$3 holds the divisor,
+// math_divisor holds the magic number and math_shift holds ceil(log2(divisor)).
+void eword_magic_divide(void)
+{
+	math_remainder$0 = math_dividend$3;	// Divisor
+	math_remainder$1 = math_dividend$0;	// Low byte of dividend for remainder
+	math_remainder$2 = 0;
+	math_dividend$3  = 0;
+	math_dword2      = 0;
+
+	// t = (dividend x magic) >> 24
+	Magic_Row (math_dividend$0);
+	Magic_Row (math_dividend$1);
+	Magic_Row (math_dividend$2);
+
+	// quotient = (t + ((dividend - t) >> 1)) >> (shift - 1)
+	math_dividend -= math_dword2;
+	math_dividend >>= 1;
+	math_dividend += math_dword2;
+	while (--counter) math_dividend >>= 1;
+
+	// Remainder < divisor < 256, so only the low bytes matter
+	mulop = math_remainder$0;
+	A = math_quotient$0;
+	mul;
+	math_remainder$1 -= A;
+	math_remainder$0 = math_remainder$1;
+	math_remainder$1 = 0;
+}
+
+#ENDIF
+
+
 void byte_multiply(void)
 {
 	math_product = 0;
@@ -245,4 +515,436 @@ void word_multiply(void)
 #ENDIF
 }
 
+
+
+// math_product_h : math_product = math_mult_da x math_mult_db, low 3 bytes of each
+void eword_multiply(void)
+{
+	math_product   = 0;
+	math_product_h = 0;
+	product_x      = 0;
+	math_mult_db$3 = 0;
+#IF HAS_MULTIPLIER
+	Product_Row (math_mult_da$0);
+	Product_Row (math_mult_da$1);
+	Product_Row (math_mult_da$2);
+
+#ELSE
+	math_mult_da$3 = 0;
+	counter = 24;
+
+	do {
+		Product_Shift_Add ();
+	} while(--counter);
+#ENDIF
+	Product_Shift_Byte ();
+}
+
+
+// math_product_h : math_product = math_mult_da x math_mult_db
+void dword_multiply(void)
+{
+	math_product   = 0;
+	math_product_h = 0;
+	product_x      = 0;
+#IF HAS_MULTIPLIER
+	Product_Row (math_mult_da$0);
+	Product_Row (math_mult_da$1);
+	Product_Row (math_mult_da$2);
+	Product_Row (math_mult_da$3);
+
+#ELSE
+	counter = 32;
+
+	do {
+		Product_Shift_Add ();
+	} while(--counter);
+#ENDIF
+}
+
+
+// Bit-by-bit square root. Remainder (0 : 2 x root) stays in math_remainder.
+static void Sqrt_Bits(void)
+{
+	math_remainder = 0;
+	math_root      = 0;
+
+	do
+	{
+		// Bring down the next 2 bits of the radicand
+		sl  math_dividend$0;
+		slc math_dividend$1;
+		slc math_dividend$2;
+		slc math_dividend$3;
+		slc math_remainder$0;
+		slc math_remainder$1;
+		slc math_remainder$2;
+
+		sl  math_dividend$0;
+		slc math_dividend$1;
+		slc math_dividend$2;
+		slc math_dividend$3;
+		slc math_remainder$0;
+		slc math_remainder$1;
+		slc math_remainder$2;
+
+		// Trial = 4 x root + 1
+		math_root <<= 1;
+		math_divisor = math_root;
+		math_divisor <<= 1;
+		math_divisor |= 0b1;
+
+		if (math_remainder >= math_divisor)
+		{
+			math_remainder -= math_divisor;
+			math_root |= 0b1;
+		}
+
+	} while(--counter);
+}
+
+
+// math_root = sqrt(math_dividend), math_dividend is a WORD
+void word_sqrt(void)
+{
+	math_dividend$2 = math_dividend$0;
+	math_dividend$3 = math_dividend$1;
+	counter = 8;
+	Sqrt_Bits();
+}
+
+
+// math_root = sqrt(math_dividend)
+void dword_sqrt(void)
+{
+	counter = 16;
+	Sqrt_Bits();
+}
+
+
+// math_quotient ~= 2^32 / math_divisor, math_divisor is a WORD [2 : 65535]
+//
+// The divisor is normalized into [0.5 : 1), seeded with the linear estimate
+// 48/17 - 32/17 x and refined by two Newton steps r = r x (2 - x x r).
+// Relative error < 0.005%.
+void word_reciprocal(void)
+{
+	if (!math_divisor$1 && (math_divisor$0 < 2))
+	{
+		math_quotient = 0xFFFFFFFF;
+		return;
+	}
+
+	// Normalize, xn = [0x8000 : 0xFFFF]
+	recip_xn    = math_mult_a;
+	recip_shift = 1;
+	while (!(recip_xn$1 & 0x80))
+	{
+		recip_xn <<= 1;
+		recip_shift++;
+	}
+
+	// r0 = 92521 - 0.941176 x xn, Q1.15
+	math_mult_a = recip_xn;
+	math_mult_b = 61681;
+	word_multiply();
+	recip_r  = 26985;	// 92521 - 65536, result always fits a WORD
+	recip_r -= product_hi;
+
+	.REPEAT 2
+		// e = 2 - xn x r, Q1.15. +1 compensates for the truncation.
+		math_mult_a = recip_xn;
+		math_mult_b = recip_r;
+		word_multiply();
+		not math_product$0;
+		not math_product$1;
+		not math_product$2;
+		not math_product$3;
+		math_product++;
+		math_mult_b = product_hi;
+		math_mult_b++;
+
+		// r = r x e
+		math_mult_a = recip_r;
+		word_multiply();
+		sl  math_product$1;
+		slc math_product$2;
+		slc math_product$3;
+		if (CF) recip_r = 0xFFFF;
+		else    recip_r = product_hi;
+	.ENDM
+
+	// Denormalize, 2^32 / x = r << (shift + 1)
+	math_quotient = recip_r;
+	do {
+		math_quotient <<= 1;
+	} while(--recip_shift);
+}
+
+
+// math_quotient = |math_mult_da - math_mult_db| x 10^6 / math_mult_db, 0xFFFFFF max
+//
+// The difference and reference are halved together until the difference
+// x 10^6 fits a DWORD and the reference fits the EWORD divisor.
+void ppm_error(void)
+{
+	math_dword2 = math_mult_db;
+	if (math_mult_da >= math_dword2) math_mult_da -= math_dword2;
+	else
+	{
+		math_dword4  = math_dword2;
+		math_dword4 -= math_mult_da;
+		math_mult_da = math_dword4;
+	}
+
+	while ((math_mult_da > 4294) || math_dword2$3)
+	{
+		math_mult_da >>= 1;
+		math_dword2  >>= 1;
+	}
+
+	if (!math_dword2)
+	{
+		math_quotient = 0xFFFFFF;
+		return;
+	}
+
+	// 10^6 = 15625 x 2^6
+	math_mult_b = 15625;
+	word_multiply();
+	math_product <<= 6;
+
+	math_divisor = math_dword2;
+	dword_divide();
+	if (math_quotient$3) math_quotient = 0xFFFFFF;
+}
+
+
+// Shift-and-add-3 conversion of the top counter bits of math_dividend
+static void BCD_Bits(void)
+{
+	math_bcd   = 0;
+	math_bcd_h = 0;
+
+	do
+	{
+		BCD_Adjust (math_bcd$0);
+		BCD_Adjust (math_bcd$1);
+		BCD_Adjust (math_bcd$2);
+		BCD_Adjust (math_bcd$3);
+		BCD_Adjust (math_bcd_h);
+
+		sl  math_dividend$0;
+		slc math_dividend$1;
+		slc math_dividend$2;
+		slc math_dividend$3;
+		BCD_Shift ();
+
+	} while(--counter);
+}
+
+
+// math_bcd_h : math_bcd = packed BCD of math_dividend$0
+void byte_to_bcd(void)
+{
+	math_dividend$3 = math_dividend$0;
+	counter = 8;
+	BCD_Bits();
+}
+
+
+// math_bcd_h : math_bcd = packed BCD of math_dividend$0 : $1
+void word_to_bcd(void)
+{
+	math_dividend$3 = math_dividend$1;
+	math_dividend$2 = math_dividend$0;
+	counter = 16;
+	BCD_Bits();
+}
+
+
+// math_bcd_h : math_bcd = packed BCD of math_dividend$0 : $2
+void eword_to_bcd(void)
+{
+	math_dividend$3 = math_dividend$2;
+	math_dividend$2 = math_dividend$1;
+	math_dividend$1 = math_dividend$0;
+	counter = 24;
+	BCD_Bits();
+}
+
+
+// math_bcd_h : math_bcd = packed BCD of math_dividend
+void dword_to_bcd(void)
+{
+	counter = 32;
+	BCD_Bits();
+}
+
+
+// Write the lowest math_shift [1 : 10] BCD digits to math_bcd_ptr, one digit
+// per byte, most significant first. Add LCD_0 for characters.
+void bcd_unpack(void)
+{
+	// Drop the unused upper digits. counter shares math_shift.
+	bcd_count = math_shift;
+	counter   = 10 - math_shift;
+	while (counter)
+	{
+		.REPEAT 4
+			sl  math_bcd$0;
+			slc math_bcd$1;
+			slc math_bcd$2;
+			slc math_bcd$3;
+			slc math_bcd_h;
+		.ENDM
+		counter--;
+	}
+
+	do
+	{
+		bcd_digit = 0;
+		.REPEAT 4
+			sl  math_bcd$0;
+			slc math_bcd$1;
+			slc math_bcd$2;
+			slc math_bcd$3;
+			slc math_bcd_h;
+			slc bcd_digit;
+		.ENDM
+		*math_bcd_ptr = bcd_digit;
+		math_bcd_ptr++;
+	} while(--bcd_count);
+}
+
+
+// math_mac_acc += math_mac_x x math_mac_c, signed 16b x 8b
+void mac_16x8(void)
+{
+	// Multiply magnitudes, fix the sign afterwards
+	mac_sign = math_mac_x$1 ^ math_mac_c;
+	if (math_mac_x$1 & 0x80)
+	{
+		not math_mac_x$0;
+		not math_mac_x$1;
+		math_mac_x++;
+	}
+	if (math_mac_c & 0x80) neg math_mac_c;
+
+#IF HAS_MULTIPLIER
+	mulop = math_mac_c;
+	A = math_mac_x$0;
+	mul;
+	math_product$0 = A;
+	math_product$1 = mulrh;
+
+	A = math_mac_x$1;
+	mul;
+	math_product$1 += A;
+	A = mulrh;
+	addc A;
+	math_product$2 = A;
+	math_product$3 = 0;
+
+#ELSE
+	math_product    = 0;
+	math_mult_da$2  = 0;
+	math_mult_da$3  = 0;
+
+	while (math_mac_c)
+	{
+		sr math_mac_c;
+		if (CF) math_product += math_mult_da;
+		math_mult_da <<= 1;
+	}
+#ENDIF
+
+	if (mac_sign & 0x80)
+	{
+		not math_product$0;
+		not math_product$1;
+		not math_product$2;
+		not math_product$3;
+		math_product++;
+	}
+
+	math_mac_acc += math_product;
+}
+
+
+// math_mac_acc += math_mac_x$0 x math_mac_c, signed 8b x 8b
+void mac_8x8(void)
+{
+	math_mac_x$1 = 0;
+	if (math_mac_x$0 & 0x80) math_mac_x$1 = 0xFF;
+	mac_16x8();
+}
+
+
+#IF MATH_FIR_ENABLE
+
+void MATH_FIR_TABLE (void);
+
+// math_mac_acc = sum of MATH_FIR_TAPS signed WORD samples at math_fir_ptr x
+// signed BYTE coefficients in MATH_FIR_TABLE. Sample 0 pairs with coefficient 0.
+void fir_filter(void)
+{
+	math_mac_acc = 0;
+	counter = 0;
+
+	do
+	{
+		math_mac_x$0 = *math_fir_ptr++;
+		math_mac_x$1 = *math_fir_ptr++;
+
+		A = counter;
+		MATH_FIR_TABLE ();
+		math_mac_c = A;
+
+		mac_16x8();
+		counter++;
+
+	} while(counter < MATH_FIR_TAPS);
+}
+
+#ENDIF
+
+
+#IF MATH_ISR_SAVE
+
+// Call at the top of an interrupt before any math routine
+void math_isr_save(void)
+{
+	math_byte1_isr  = math_byte1;
+	math_dword1_isr = math_dword1;
+	math_dword2_isr = math_dword2;
+	math_dword3_isr = math_dword3;
+	math_dword4_isr = math_dword4;
+#IF HAS_MULTIPLIER
+	math_mulop_isr  = mulop;
+	math_mulrh_isr  = mulrh;
+#ENDIF
+}
+
+
+// Call before leaving the interrupt. ACC is clobbered, so restore it after (popaf).
+void math_isr_restore(void)
+{
+	math_byte1  = math_byte1_isr;
+	math_dword1 = math_dword1_isr;
+	math_dword2 = math_dword2_isr;
+	math_dword3 = math_dword3_isr;
+	math_dword4 = math_dword4_isr;
+#IF HAS_MULTIPLIER
+	// mulrh cannot be written. The high byte of a product is at most 0xFE,
+	// and 255 x (h + 1) = 256 x h + (255 - h), so a dummy mul restores it.
+	mulop = math_mulrh_isr + 1;
+	A = 0xFF;
+	mul;
+	mulop = math_mulop_isr;
+#ENDIF
+}
+
+#ENDIF
+
 #ENDIF // PERIPH_MATH
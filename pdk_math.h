@@ -2,26 +2,73 @@
 
 Basic multiplication and division functions.
 
-ROM Consumed : 284B / 0x11C
-RAM Consumed : 11B  / 0x0B
+ROM Consumed : 818B / 0x332  -  1090B / 0x442 WITH MULTIPLIER
+RAM Consumed : 17B  / 0x11
 
 
 NOTE:
 
-	Function maximum run time @ 4 MHz
+	Function maximum run time @ 4 MHz. Worst cases from tools/math_model.cpp,
+	which estimates cycles per statement at 4 cycles per us. Rows marked *
+	are not in the model and are hand counts from the code.
 
-	byte_divide   28  us
-	word_divide   92  us
-	eword_divide  148 us
-	dword_divide  204 us
+	byte_divide   29  us
+	word_divide   93  us
+	eword_divide  143 us
+	dword_divide  208 us
+	Eword_Divide_Const 70 us WITH MULTIPLIER, 150 us otherwise
 
-	byte_multiply 30  us  3 us WITH MULTIPLIER
-	word_multiply 62  us  9 us WITH MULTIPLIER 
+	eword_divide and dword_divide skip leading zero bytes of the dividend,
+	so run time scales with the dividend width instead of the type width.
+
+	Dividend width  8b      16b     24b     32b
+	eword_divide    61 us   102 us  143 us  -
+	dword_divide    71 us   118 us  165 us  208 us
+
+	byte_multiply  39  us  4  us WITH MULTIPLIER
+	word_multiply  79  us  18 us WITH MULTIPLIER
+	eword_multiply 161 us  45 us WITH MULTIPLIER
+	dword_multiply 206 us  52 us WITH MULTIPLIER
+
+	word_sqrt       94  us
+	dword_sqrt      181 us
+	word_reciprocal 407 us  167 us WITH MULTIPLIER
+	ppm_error       270 us  215 us WITH MULTIPLIER *
+
+	byte_to_bcd     66  us
+	word_to_bcd     152 us
+	eword_to_bcd    260 us
+	dword_to_bcd    386 us
+	bcd_unpack      92  us  10 digits
+
+	mac_8x8         42  us  11 us WITH MULTIPLIER *
+	mac_16x8        40  us  10 us WITH MULTIPLIER *
+	fir_filter      +45 us  +14 us WITH MULTIPLIER, per tap *
+
+	math_isr_save    9 us  10 us WITH MULTIPLIER *
+	math_isr_restore 9 us  11 us WITH MULTIPLIER *
+
+
+ISR CONTEXT:
+
+	All routines share one static scratch block. An interrupt that does math
+	would corrupt a routine running in the main loop. Set MATH_ISR_SAVE in
+	system_settings.h and bracket the interrupt math with:
+
+		pushaf;
+		math_isr_save();
+		...
+		math_isr_restore();
+		popaf;
+
+	The shadow block costs +17B RAM (+19B WITH MULTIPLIER) and ~40B ROM.
 
 	Division framework sourced from Wikipedia Division Algorithm, Long Div.
 	Div was made more efficient by having quotient and dividend share memory.
 	Multiplication framework (non-mulop) duplicated from Padauk Code Gen
 	Multiplication framework (mulop) developed from experience
+	Constant division from Granlund & Montgomery, Division by Invariant Integers
+	Square root is the digit-by-digit method, 2 radicand bits per root bit
 
 
 This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
@@ -46,6 +93,23 @@ EXTERN WORD &math_mult_a;
 EXTERN WORD &math_mult_b;
 EXTERN DWORD &math_product;
 
+EXTERN DWORD &math_mult_da;   // eword/dword multiply operands
+EXTERN DWORD &math_mult_db;
+EXTERN DWORD &math_product_h; // Upper 4B of eword/dword product
+
+EXTERN WORD  &math_root;      // word_sqrt / dword_sqrt result
+
+EXTERN DWORD &math_bcd;       // Packed BCD digits 7 : 0
+EXTERN BYTE  &math_bcd_h;     // Packed BCD digits 9 : 8
+EXTERN WORD  &math_bcd_ptr;   // bcd_unpack destination
+
+EXTERN DWORD &math_mac_acc;   // Signed MAC accumulator
+EXTERN WORD  &math_mac_x;     // Signed MAC sample
+EXTERN BYTE  &math_mac_c;     // Signed MAC coefficient
+EXTERN WORD  &math_fir_ptr;   // fir_filter sample buffer
+
+EXTERN BYTE  &math_shift;
+
 
 //===================//
 // PROGRAM FUNCTIONS //
@@ -56,4 +120,78 @@ void word_divide   (void);
 void eword_divide  (void);
 void dword_divide  (void);
 void byte_multiply (void);
-void word_multiply (void);
\ No newline at end of file
+void word_multiply (void);
+void eword_multiply(void);
+void dword_multiply(void);
+void word_sqrt     (void);
+void dword_sqrt    (void);
+void word_reciprocal (void);
+void ppm_error     (void);
+void byte_to_bcd   (void);
+void word_to_bcd   (void);
+void eword_to_bcd  (void);
+void dword_to_bcd  (void);
+void bcd_unpack    (void);
+void mac_8x8       (void);
+void mac_16x8      (void);
+#IF MATH_FIR_ENABLE
+void fir_filter    (void);
+#ENDIF
+#IF MATH_ISR_SAVE
+void math_isr_save    (void);
+void math_isr_restore (void);
+#ENDIF
+#IF HAS_MULTIPLIER
+void eword_magic_divide (void);
+#ENDIF
+
+
+//========//
+// MACROS //
+//========//
+
+// math_quotient = math_dividend / d, with math_remainder, for a constant d in [2 : 255].
+// math_dividend must fit in an EWORD. math_divisor is overwritten.
+//
+// With a multiplier the divide becomes a multiply by a magic reciprocal
+// m = 2^24 x (2^l - d) / d + 1, with l = ceil(log2(d)), solved at compile time.
+
+Eword_Divide_Magic	macro	d, l
+	math_divisor    = ((((1 << l) - d) << 24) / d) + 1;
+	math_dividend$3 = d;
+	math_shift      = l;
+	eword_magic_divide();
+	endm
+
+
+Eword_Divide_Const	macro	d
+	#IF d < 2
+		.error Eword_Divide_Const divisor must be [2 : 255]
+	#ENDIF
+	#IF d > 255
+		.error Eword_Divide_Const divisor must be [2 : 255]
+	#ENDIF
+
+	#IF HAS_MULTIPLIER
+		#IF d > 128
+			Eword_Divide_Magic (d, 8)
+		#ELSEIF d > 64
+			Eword_Divide_Magic (d, 7)
+		#ELSEIF d > 32
+			Eword_Divide_Magic (d, 6)
+		#ELSEIF d > 16
+			Eword_Divide_Magic (d, 5)
+		#ELSEIF d > 8
+			Eword_Divide_Magic (d, 4)
+		#ELSEIF d > 4
+			Eword_Divide_Magic (d, 3)
+		#ELSEIF d > 2
+			Eword_Divide_Magic (d, 2)
+		#ELSE
+			Eword_Divide_Magic (d, 1)
+		#ENDIF
+	#ELSE
+		math_divisor = d;
+		eword_divide();
+	#ENDIF
+	endm
@@ -0,0 +1,271 @@
+/* pdk_postscale.c
+
+Software postscaler for slow outputs. A hardware timer ticks at POST_TICK_HZ
+and the tick interrupt toggles POST_PIN after a counted number of ticks, so
+periods of minutes stay accurate. Define PERIPH_POSTSCL in system_settings.h
+
+ROM Consumed : ~190B
+RAM Consumed :  22B / 0x16
+
+
+NOTE:
+
+	pwm11_target_freq and timer8_target_freq are whole Hz and the hardware
+	dividers stop near 2 Hz. Here the target is a period in microseconds,
+	post_period_us, or a frequency in milli-Hz, post_freq_mhz. The hardware
+	timer is solved once for the tick rate and only the tick count changes.
+
+	With the solver report enabled for the timer source, the tick count is
+	worked out from the achieved tick rate rather than the target, so the
+	hardware solver error drops out. post_actual_us holds the period that
+	results. Error from counting is below half a tick per half period:
+
+		POST_TICK_HZ 1000, 1 Hz     : 500 ticks,    < 0.1%
+		POST_TICK_HZ 1000, 0.01 Hz  : 50000 ticks,  < 0.001%
+
+	Periods up to 0x1F000000 us, ~8.6 minutes. Longer periods are clamped.
+
+	Place Postscale_Interrupt under the POST_INTR flag in the Interrupt
+	function. It costs a 3 byte decrement per tick. post_event is set on
+	every rising edge of POST_PIN for software that counts output periods.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+#include "system_settings.h"
+
+#IF PERIPH_POSTSCL
+#include "pdk_math.h"
+#include "pdk_timer_8b.h"
+#include "pdk_pwm_11b.h"
+
+
+//======================//
+// VARIABLES AND MACROS //
+//======================//
+
+BYTE       post_flags = 0;
+STATIC BIT post_module_initialized : post_flags.?;
+BIT        post_event              : post_flags.?;
+
+DWORD post_period_us = 1000000;
+EWORD post_freq_mhz  = 1000;
+DWORD post_actual_us = 0;
+
+STATIC EWORD post_tick16;   // Tick period in 1/16 us
+STATIC EWORD post_reload;   // Ticks per half period
+STATIC EWORD post_remain;   // Ticks left in this half period
+STATIC BYTE  post_inten;    // Caller's INTEN while post_reload is written
+
+
+// Longest period, keeps the half period in 1/16 us below 2^32
+POST_MAX_US   =>  0x1F000000;
+
+
+//===================//
+// PROGRAM FUNCTIONS //
+//===================//
+
+
+// INITIALIZE
+// Solves the hardware tick once. Only the tick count changes afterwards.
+void Postscale_Initialize(void)
+{
+	if (!post_module_initialized)
+	{
+		$ POST_PIN OUT, LOW;
+		post_module_initialized = 1;
+
+		#IFIDNI POST_TIMER_SRC, PWM0
+			PWM11_0_Initialize();
+			pwm11_target_freq  = POST_TICK_HZ;
+			pwm11_use_solver   = 1;
+			pwm11_duty_percent = 50;
+			PWM11_0_Set_Parameters();
+
+			#IF PWM_SOLVER_REPORT
+				math_divisor = pwm11_actual_freq;
+			#ELSE
+				math_divisor = POST_TICK_HZ;
+			#ENDIF
+
+		#ELSE
+			// Period mode interrupts twice per period
+			timer8_target_freq = POST_TICK_HZ / 2;
+			timer8_use_solver  = 1;
+
+			#IFIDNI POST_TIMER_SRC, TM2
+				Timer2_Initialize();
+				Timer2_Set_Parameters();
+			#ELSE
+				Timer3_Initialize();
+				Timer3_Set_Parameters();
+			#ENDIF
+
+			#IF TIMER8_SOLVER_REPORT
+				math_divisor   = timer8_actual_freq;
+				math_divisor <<= 1;
+			#ELSE
+				math_divisor = POST_TICK_HZ;
+			#ENDIF
+		#ENDIF
+
+		if (!math_divisor) math_divisor = POST_TICK_HZ;
+
+		// Tick period in 1/16 us, rounded
+		math_dividend   = math_divisor;
+		math_dividend >>= 1;
+		math_dividend  += 16000000;
+		dword_divide();
+		post_tick16 = math_quotient;
+
+		Postscale_Set_Period();
+	}
+}
+
+
+// SET PERIOD
+// Output period from post_period_us. A running output picks it up at the next toggle.
+void Postscale_Set_Period(void)
+{
+	if (post_module_initialized)
+	{
+		if (post_period_us > POST_MAX_US) post_period_us = POST_MAX_US;
+
+		// Ticks per half period = period x 16 / 2 / tick16, rounded
+		math_dividend   = post_period_us;
+		math_dividend <<= 3;
+		math_divisor    = post_tick16;
+		dword_divide();
+
+		math_remainder <<= 1;
+		if (math_remainder >= math_divisor) math_quotient++;
+		if (!math_quotient) math_quotient = 1;
+
+		// Hold off the tick interrupt, the global enable is left alone
+		post_inten = INTEN;
+		INTEN = 0;
+		post_reload = math_quotient;
+		if (post_remain > post_reload) post_remain = post_reload;
+		INTEN = post_inten;
+
+		// Achieved period = 2 x ticks x tick16 / 16
+		math_mult_da = math_quotient;
+		math_mult_db = post_tick16;
+		eword_multiply();
+		math_product >>= 3;
+		post_actual_us = math_product;
+	}
+}
+
+
+// SET MILLI-HZ
+// Output frequency from post_freq_mhz, 1 mHz is a 1000 s period (clamped)
+void Postscale_Set_mHz(void)
+{
+	if (post_module_initialized)
+	{
+		if (!post_freq_mhz) post_freq_mhz = 1;
+
+		// Period = 10^9 / mHz, rounded
+		math_dividend = 1000000000;
+		math_divisor  = post_freq_mhz;
+		dword_divide();
+
+		math_remainder <<= 1;
+		if (math_remainder >= math_divisor) math_quotient++;
+
+		post_period_us = math_quotient;
+		Postscale_Set_Period();
+	}
+}
+
+
+// START
+void Postscale_Start(void)
+{
+	if (post_module_initialized)
+	{
+		post_remain = post_reload;
+		POST_PIN    = 0;
+
+		INTRQ.POST_INTR = 0;
+		INTEN.POST_INTR = 1;
+
+		#IFIDNI POST_TIMER_SRC, PWM0
+			PWM11_0_Start();
+		#ELSEIFIDNI POST_TIMER_SRC, TM2
+			Timer2_Start();
+		#ELSE
+			Timer3_Start();
+		#ENDIF
+	}
+}
+
+
+// STOP
+void Postscale_Stop(void)
+{
+	if (post_module_initialized)
+	{
+		#IFIDNI POST_TIMER_SRC, PWM0
+			PWM11_0_Stop();
+		#ELSEIFIDNI POST_TIMER_SRC, TM2
+			Timer2_Stop();
+		#ELSE
+			Timer3_Stop();
+		#ENDIF
+
+		INTEN.POST_INTR = 0;
+		POST_PIN        = 0;
+	}
+}
+
+
+// INTERRUPT
+void Postscale_Interrupt(void)
+{
+	post_remain--;
+	if (!post_remain)
+	{
+		post_remain = post_reload;
+
+		if (POST_PIN) POST_PIN = 0;
+		else
+		{
+			POST_PIN   = 1;
+			post_event = 1;
+		}
+	}
+
+	INTRQ.POST_INTR = 0;
+}
+
+
+// RELEASE
+void Postscale_Release(void)
+{
+	if (post_module_initialized)
+	{
+		Postscale_Stop();
+
+		#IFIDNI POST_TIMER_SRC, PWM0
+			PWM11_0_Release();
+		#ELSEIFIDNI POST_TIMER_SRC, TM2
+			Timer2_Release();
+		#ELSE
+			Timer3_Release();
+		#ENDIF
+
+		$ POST_PIN IN;
+		post_module_initialized = 0;
+	}
+}
+
+#ENDIF // PERIPH_POSTSCL
@@ -0,0 +1,61 @@
+/* pdk_postscale.h
+
+Software postscaler for slow outputs. A hardware timer ticks at POST_TICK_HZ
+and the tick interrupt toggles POST_PIN after a counted number of ticks, so
+periods of minutes stay accurate. Define PERIPH_POSTSCL in system_settings.h
+
+ROM Consumed : ~190B
+RAM Consumed :  22B / 0x16
+
+
+NOTE:
+
+	pwm11_target_freq and timer8_target_freq are whole Hz and the hardware
+	dividers stop near 2 Hz. Here the target is a period in microseconds,
+	post_period_us, or a frequency in milli-Hz, post_freq_mhz. The hardware
+	timer is solved once for the tick rate and only the tick count changes.
+
+	With the solver report enabled for the timer source, the tick count is
+	worked out from the achieved tick rate rather than the target, so the
+	hardware solver error drops out. post_actual_us holds the period that
+	results. Error from counting is below half a tick per half period:
+
+		POST_TICK_HZ 1000, 1 Hz     : 500 ticks,    < 0.1%
+		POST_TICK_HZ 1000, 0.01 Hz  : 50000 ticks,  < 0.001%
+
+	Periods up to 0x1F000000 us, ~8.6 minutes. Longer periods are clamped.
+
+	Place Postscale_Interrupt under the POST_INTR flag in the Interrupt
+	function. It costs a 3 byte decrement per tick. post_event is set on
+	every rising edge of POST_PIN for software that counts output periods.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+//===========//
+// VARIABLES //
+//===========//
+
+EXTERN DWORD post_period_us;  // Output period for Postscale_Set_Period
+EXTERN EWORD post_freq_mhz;   // Output milli-Hz for Postscale_Set_mHz
+EXTERN DWORD post_actual_us;  // Period achieved by the last set
+EXTERN BIT   post_event;      // Set on each rising edge, cleared by user
+
+
+//===================//
+// PROGRAM FUNCTIONS //
+//===================//
+
+void	Postscale_Initialize  (void);
+void	Postscale_Set_Period  (void);
+void	Postscale_Set_mHz     (void);
+void	Postscale_Start       (void);
+void	Postscale_Stop        (void);
+void	Postscale_Interrupt   (void);
+void	Postscale_Release     (void);
@@ -27,6 +27,22 @@ NOTE:
 	computation times and a 100x performance improvement at the expense of memory and slightly
 	inferior error rates. Error rate might be reduced by multiplying Clk x2 instead of clock
 	ratio. This would require DWORD division, which currently does not exist.
+
+	When PWM_0_TARGET / PWM_1_TARGET / PWM_2_TARGET is set in system_settings.h,
+	that generator is solved at build time and Set_Parameters only writes registers.
+	pwm11_use_solver and the pwm11_* parameters are ignored for that generator.
+	With every used generator solved at build time, PWM_SOLVER_ENABLE can be set
+	to 0 to drop the solver and the math library.
+
+	LIVE UPDATE: Start issues a PWM reset, so calling Stop/Set/Start on a
+	running generator cuts the current period short. With PWM_LIVE_UPDATE
+	enabled and pwm11_live_update set, Set_Parameters and Apply_Preset only
+	stage the new registers. PWM11_X_Commit loads them without a reset and
+	should run once per period. Only G0 has an interrupt; G1/G2 can commit
+	from it when they share its period, or from a timer tied to their period.
+
+	Generators 0/1/2 share one source, pdk_pwm_11b.inc, included once per
+	generator enabled with PWM_USE_Gx. ROM grows per enabled generator.
 		
 	
 	In the PMS132 datasheet frequency can be solved with the following equation:
@@ -39,7 +55,18 @@ NOTE:
 
 	Autosolver Testing:
 	PWM CLK = SYSCLK = 4000000 Hz
-	Time to solve    = 3 ms
+	Time to solve    = 3 ms with word_divide per scalar. The scan now
+	                   skips scalars that give a counter above 2047, stops
+	                   on an exact result and, with a multiplier, uses a
+	                   reciprocal table with multiply-to-verify. Estimated
+	                   ~18 us per scalar: ~0.3 ms for ratios above 32768
+	                   (16 scalars at most), ~0.55 ms worst case for a
+	                   ratio below 2048 that is a multiple of 32 (all 32
+	                   scalars). Below 32768 the closest result can need
+	                   every scalar with a counter below 2048, each one a
+	                   divide, so 0.3 ms is only held with pwm11_solve_ppm
+	                   set. Results match the old scan for every ratio,
+	                   see tools/pwm11_solver_check.cpp.
 
 	Target  = 200000
 	Result  = 200000
@@ -81,6 +108,50 @@ NOTE:
 	Result  = 1.908
 	Error   = 90.98%
 
+	SOLVER REPORT: With PWM_SOLVER_REPORT set, every run time solve writes the
+	achieved frequency to pwm11_actual_freq and the error against the target to
+	pwm11_error_ppm, so out of range targets like the one above can be caught.
+	Adds ~700us per solve.
+
+	SPEED / ACCURACY: pwm11_solve_ppm = 0 scans every scalar with a counter below
+	2048 for the closest result, ~0.55 ms worst case, see above. Any other
+	value stops the scan at the first scalar within that many ppm, which
+	bounds solve time on the hot path. Exact results stop the scan early
+	either way. Default is PWM_SOLVE_PPM.
+
+	GLOBAL SOLVE: The default solver takes the smallest prescaler that fits and
+	rounds the clock ratio down, which is where the 0.3% above comes from. With
+	PWM_SOLVE_GLOBAL set, the ratio is kept to 1/256 and every prescaler is
+	scanned for the odd counter nearest to it, below or above. Scalars that
+	only repeat a prescaler x scalar product already tried are skipped, so
+	at most 104 candidates are checked. pwm11_solve_ppm still stops the scan
+	early. Results are never worse than the default solver and are within
+	2/256 count of an exhaustive search of every register setting, see
+	tools/pwm11_solver_check.cpp.
+
+		Target 17561 : 17544 Hz, 0.098%
+		Target 14000 : 14011 Hz, 0.075%
+		Target  6500 :  6499 Hz, 0.019%
+
+	Time to solve ~2.5 ms worst case with a multiplier (2 dword_divide plus
+	104 x ~18 us), ~0.6 ms when an exact result is found at prescaler 1.
+	Without a multiplier each candidate is a word_divide, ~10 ms worst case.
+	Meant for Set_Parameters outside the hot path.
+
+	DITHER: With PWM_DITHER set, PWM11_X_Set_Duty16 takes pwm11_duty16, where
+	[0 : 65535] spans [0 : 100%). The whole duty steps go to the duty register
+	and the rest becomes a 16-bit fraction of one step. PWM11_X_Dither adds the
+	fraction to an accumulator once per period and writes duty + 1 step on the
+	periods that carry, so the average duty has 16-bit resolution at any
+	counter. ~20 cycles per call, no math library, safe at the PWM rate.
+	Call it from INTR_PWM with PWM_0_INT_ZERO set, so the new duty is written
+	early in the period. Only G0 has an interrupt; G1/G2 can dither from it
+	when they share its period. Set_Parameters and Apply_Preset hold the
+	solved duty until Set_Duty16 is called again. Low fractions repeat slowly,
+	e.g. 1/256 of a step is 1 period in 256, so filter the output to match.
+	While they update the dither state these calls clear INTEN and then put
+	it back. The global interrupt enable is never changed.
+
 
 This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
 Any modifications or distributions have to be licensed under GPLv3.
@@ -111,6 +182,7 @@ BYTE pwm11_prescalar = 0; // 6-bit  [1, 4, 16, 64]
 WORD pwm11_scalar    = 0; // 5-bit  [0 : 31]
 WORD pwm11_duty      = 0; // 11-bit [0 : 2047]
 WORD pwm11_counter   = 0; // 11-bit [0 : 2046] in steps of 2
+BYTE pwm11_preset    = 0; // ROM preset index for PWM11_X_Apply_Preset
 
 BIT  pwm11_pwm0_init  : pwm11_flags.?;
 BIT  pwm11_pwm1_init  : pwm11_flags.?;
@@ -118,14 +190,91 @@ BIT  pwm11_pwm2_init  : pwm11_flags.?;
 BIT  pwm11_use_solver : pwm11_flags.?; // Flag to select PWM solver, if available
 
 
+#IF PWM_LIVE_UPDATE
+
+	BIT  pwm11_live_update  : pwm11_flags.?; // Set_Parameters stages values for PWM11_X_Commit
+	BIT  pwm11_g0_pending   : pwm11_flags.?;
+	BIT  pwm11_g1_pending   : pwm11_flags.?;
+	BIT  pwm11_g2_pending   : pwm11_flags.?;
+
+	#IF PWM_USE_G0
+		STATIC BYTE pwm11_g0_next_scl  = 0;
+		STATIC WORD pwm11_g0_next_duty = 0;
+		STATIC WORD pwm11_g0_next_cnt  = 0;
+	#ENDIF
+
+	#IF PWM_USE_G1
+		STATIC BYTE pwm11_g1_next_scl  = 0;
+		STATIC WORD pwm11_g1_next_duty = 0;
+		STATIC WORD pwm11_g1_next_cnt  = 0;
+	#ENDIF
+
+	#IF PWM_USE_G2
+		STATIC BYTE pwm11_g2_next_scl  = 0;
+		STATIC WORD pwm11_g2_next_duty = 0;
+		STATIC WORD pwm11_g2_next_cnt  = 0;
+	#ENDIF
+
+#ENDIF
+
+
+#IF PWM_DITHER
+
+	WORD pwm11_duty16 = 0; // Duty for PWM11_X_Set_Duty16, [0 : 65535] is [0 : 100%)
+	STATIC BYTE pwm11_inten = 0; // Caller's INTEN while the dither state is written
+
+	// Per generator: accumulator, duty fraction, counter + 1,
+	// duty register value and duty + 1 step, L in $0 and H in $1
+	#IF PWM_USE_G0
+		STATIC WORD pwm11_g0_dth_acc  = 0;
+		STATIC WORD pwm11_g0_dth_frac = 0;
+		STATIC WORD pwm11_g0_dth_top  = 0;
+		STATIC WORD pwm11_g0_dth_lo   = 0;
+		STATIC WORD pwm11_g0_dth_hi   = 0;
+	#ENDIF
+
+	#IF PWM_USE_G1
+		STATIC WORD pwm11_g1_dth_acc  = 0;
+		STATIC WORD pwm11_g1_dth_frac = 0;
+		STATIC WORD pwm11_g1_dth_top  = 0;
+		STATIC WORD pwm11_g1_dth_lo   = 0;
+		STATIC WORD pwm11_g1_dth_hi   = 0;
+	#ENDIF
+
+	#IF PWM_USE_G2
+		STATIC WORD pwm11_g2_dth_acc  = 0;
+		STATIC WORD pwm11_g2_dth_frac = 0;
+		STATIC WORD pwm11_g2_dth_top  = 0;
+		STATIC WORD pwm11_g2_dth_lo   = 0;
+		STATIC WORD pwm11_g2_dth_hi   = 0;
+	#ENDIF
+
+#ENDIF
+
+
 #IF PWM_SOLVER_ENABLE
 
 	STATIC EWORD  pwm11_clock_ratio;	// PWM_Clk / PWM_Target, pulses per second
 	STATIC EWORD  pwm11_clk_freq;		// Hz
 	STATIC BYTE  &pwm11_tolerance    = pwm11_clk_freq$0;
 	STATIC BYTE  &pwm11_scalar_temp  = pwm11_clk_freq$1;
+	STATIC BYTE  &pwm11_leftover     = pwm11_clk_freq$2;
 	BYTE         &pwm11_duty_percent = pwm11_duty$0;
 	EWORD        &pwm11_target_freq  = pwm11_clock_ratio$0;	// Hz
+	WORD          pwm11_solve_ppm    = PWM_SOLVE_PPM;		// 0: Best result, other: First result within ppm
+	STATIC BYTE   pwm11_solve_tol    = 0;					// pwm11_solve_ppm in ratio counts
+
+	#IF PWM_SOLVE_GLOBAL
+		STATIC DWORD pwm11_ratio_fx;						// 2 x PWM_Clk / PWM_Target, 24.8 fixed point
+		STATIC EWORD pwm11_best_err;						// 1/256 ratio counts x prescaler
+		STATIC EWORD pwm11_global_tol;						// pwm11_solve_ppm in the same units
+		STATIC BYTE  pwm11_best_pre;						// Prescaler shifts of the best result
+	#ENDIF
+
+	#IF PWM_SOLVER_REPORT
+		EWORD pwm11_actual_freq  = 0;						// Hz, result of the last solve
+		EWORD pwm11_error_ppm    = 0;						// |actual - target| / target x 10^6
+	#ENDIF
 
 #ENDIF
 
@@ -136,10 +285,320 @@ BIT  pwm11_use_solver : pwm11_flags.?; // Flag to select PWM solver, if availabl
 
 #IF PWM_SOLVER_ENABLE
 
+#IF HAS_MULTIPLIER
+
+// ceil(2^16 / scalar), low byte
+static void PWM11_Recip_L(void)
+{
+	pcadd A;
+	ret 0x00;		// 0, 1 unused
+	ret 0x00;
+	ret 0x00;
+	ret 0x56;
+	ret 0x00;
+	ret 0x34;
+	ret 0xAB;
+	ret 0x93;
+	ret 0x00;
+	ret 0x72;
+	ret 0x9A;
+	ret 0x46;
+	ret 0x56;
+	ret 0xB2;
+	ret 0x4A;
+	ret 0x12;
+	ret 0x00;
+	ret 0x10;
+	ret 0x39;
+	ret 0x7A;
+	ret 0xCD;
+	ret 0x31;
+	ret 0xA3;
+	ret 0x22;
+	ret 0xAB;
+	ret 0x3E;
+	ret 0xD9;
+	ret 0x7C;
+	ret 0x25;
+	ret 0xD4;
+	ret 0x89;
+	ret 0x43;
+	ret 0x00;
+}
+
+
+// ceil(2^16 / scalar), high byte
+static void PWM11_Recip_H(void)
+{
+	pcadd A;
+	ret 0x00;		// 0, 1 unused
+	ret 0x00;
+	ret 0x80;
+	ret 0x55;
+	ret 0x40;
+	ret 0x33;
+	ret 0x2A;
+	ret 0x24;
+	ret 0x20;
+	ret 0x1C;
+	ret 0x19;
+	ret 0x17;
+	ret 0x15;
+	ret 0x13;
+	ret 0x12;
+	ret 0x11;
+	ret 0x10;
+	ret 0x0F;
+	ret 0x0E;
+	ret 0x0D;
+	ret 0x0C;
+	ret 0x0C;
+	ret 0x0B;
+	ret 0x0B;
+	ret 0x0A;
+	ret 0x0A;
+	ret 0x09;
+	ret 0x09;
+	ret 0x09;
+	ret 0x08;
+	ret 0x08;
+	ret 0x08;
+	ret 0x08;
+}
+
+#ENDIF
+
+
+// math_mult_b = pwm11_clock_ratio / pwm11_scalar_temp, pwm11_leftover = remainder.
+// pwm11_clock_ratio must fit 16 bits and the quotient must fit 11 bits.
+static void Divide_Scalar(void)
+{
+#IF HAS_MULTIPLIER
+
+	// Scalar 1 has no 16-bit reciprocal
+	if (pwm11_scalar_temp == 1)
+	{
+		math_mult_b$0  = pwm11_clock_ratio$0;
+		math_mult_b$1  = pwm11_clock_ratio$1;
+		pwm11_leftover = 0;
+		return;
+	}
+
+	// math_mult_a : reciprocal, then counter x scalar
+	// math_mult_b : counter
+	A = pwm11_scalar_temp;
+	PWM11_Recip_L();
+	math_mult_a$0 = A;
+	A = pwm11_scalar_temp;
+	PWM11_Recip_H();
+	math_mult_a$1 = A;
+
+	// Counter = (ratio x reciprocal) >> 16, exact or 1 high
+	math_product = 0;
+	mulop = math_mult_a$0;
+	A = pwm11_clock_ratio$0;
+	mul;
+	math_product$0 = mulrh;
+	A = pwm11_clock_ratio$1;
+	mul;
+	math_product += A;
+	math_product += (mulrh << 8);
+
+	mulop = math_mult_a$1;
+	A = pwm11_clock_ratio$0;
+	mul;
+	math_product += A;
+	math_product += (mulrh << 8);
+	A = pwm11_clock_ratio$1;
+	mul;
+	math_product += (A << 8);
+	math_product += (mulrh << 16);
+
+	math_mult_b$0 = math_product$1;
+	math_mult_b$1 = math_product$2;
+
+	// Verify by multiplying back, step down once if high
+	mulop = pwm11_scalar_temp;
+	A = math_mult_b$0;
+	mul;
+	math_mult_a$0 = A;
+	math_mult_a$1 = mulrh;
+	A = math_mult_b$1;
+	mul;
+	math_mult_a$1 += A;
+
+	if (math_mult_a > pwm11_clock_ratio)
+	{
+		math_mult_b--;
+		math_mult_a -= pwm11_scalar_temp;
+	}
+
+	// Leftover is below the scalar, so the low bytes are enough
+	pwm11_leftover = pwm11_clock_ratio$0 - math_mult_a$0;
+
+#ELSE
+
+	math_dividend = pwm11_clock_ratio;
+	math_divisor  = pwm11_scalar_temp;
+	word_divide();
+
+	pwm11_leftover = math_remainder$0;	// Below the scalar
+	math_mult_b    = math_quotient;
+
+#ENDIF
+}
+
+
+#IF PWM_SOLVE_GLOBAL
+
+// Closest result over every prescaler, see GLOBAL SOLVE
+static void Solve_PWM_Global(void)
+{
+	if (!pwm11_target_freq) pwm11_target_freq = (pwm11_clk_freq >> 4);
+
+	#IF PWM_SOLVER_REPORT
+		pwm11_actual_freq = pwm11_target_freq;	// Target, kept for PWM11_Report
+	#ENDIF
+
+	// Ratio = 2 x clk freq / pwm freq in 24.8 fixed point.
+	// Clock is doubled, see DOCUMENTATION ERROR.
+	math_dividend   = pwm11_clk_freq;
+	math_dividend <<= 1;
+	math_divisor    = pwm11_target_freq;
+	dword_divide();
+
+	pwm11_ratio_fx$0 = 0;
+	pwm11_ratio_fx$1 = math_quotient$0;
+	pwm11_ratio_fx$2 = math_quotient$1;
+	pwm11_ratio_fx$3 = math_quotient$2;
+	if (math_quotient$3) pwm11_ratio_fx = 0xFFFFFFFF;	// Below range at every prescaler
+
+	math_dividend   = math_remainder;
+	math_dividend <<= 8;
+	dword_divide();
+	pwm11_ratio_fx$0 = math_quotient$0;
+
+
+	// Error allowed by pwm11_solve_ppm in 1/256 ratio counts, ratio x ppm / 2^12.
+	// 2^20 is used for 10^6, so the limit is ~5% tighter than asked.
+	pwm11_global_tol = 0;
+	if (pwm11_solve_ppm)
+	{
+		math_mult_a$0 = pwm11_ratio_fx$2;
+		math_mult_a$1 = pwm11_ratio_fx$3;
+		math_mult_b   = pwm11_solve_ppm;
+		word_multiply();
+		math_product >>= 4;
+
+		if (math_product$3) pwm11_global_tol = 0xFFFFFF;
+		else
+		{
+			pwm11_global_tol$0 = math_product$0;
+			pwm11_global_tol$1 = math_product$1;
+			pwm11_global_tol$2 = math_product$2;
+		}
+	}
+
+
+	// Scan every prescaler whose ratio fits 16 bits. Errors are scaled by the
+	// prescaler so they compare across prescalers. Ties keep the smaller
+	// prescaler and scalar, which leaves the larger counter for duty steps.
+	pwm11_best_err  = 0xFFFFFF;
+	pwm11_best_pre  = 0;
+	pwm11_counter   = 0;
+	pwm11_scalar    = 0;
+	pwm11_prescalar = 0;	// Shifts, 2 per prescaler step
+
+	while (pwm11_prescalar < 8)
+	{
+		if (!pwm11_ratio_fx$3)
+		{
+			pwm11_clock_ratio$0 = pwm11_ratio_fx$1;
+			pwm11_clock_ratio$1 = pwm11_ratio_fx$2;
+			pwm11_clock_ratio$2 = 0;
+
+			// Scalars below ratio / 2048 + 1 give a counter above 2047. Above
+			// prescaler 1, scalars below 9 repeat a product already tried.
+			pwm11_scalar_temp = pwm11_clock_ratio$1 >> 3;
+			pwm11_scalar_temp++;
+			if (pwm11_prescalar && (pwm11_scalar_temp < 9)) pwm11_scalar_temp = 9;
+
+			while (pwm11_scalar_temp < 33)
+			{
+				Divide_Scalar();
+
+				// Counter x scalar is below the ratio by leftover x 256 + fraction
+				math_mult_da   = 0;
+				math_mult_da$0 = pwm11_ratio_fx$0;
+				math_mult_da$1 = pwm11_leftover;
+
+				// Even counter: counter + 1 is above by scalar x 256 - that
+				if (!math_mult_b.0)
+				{
+					math_mult_b++;
+					math_mult_a    = ~math_mult_a;
+					math_mult_a++;
+					math_mult_a$1 += pwm11_scalar_temp;
+				}
+
+				pwm11_tolerance = pwm11_prescalar;
+				while (pwm11_tolerance)
+				{
+					math_mult_da <<= 1;
+					pwm11_tolerance--;
+				}
+
+				if (math_mult_da < pwm11_best_err)
+				{
+					pwm11_best_err = math_mult_da;
+					pwm11_best_pre = pwm11_prescalar;
+					pwm11_counter  = math_mult_b;
+					pwm11_scalar   = pwm11_scalar_temp;
+
+					if (pwm11_best_err <= pwm11_global_tol)	// Exact, or good enough
+					{
+						pwm11_prescalar = 8;
+						break;
+					}
+				}
+
+				pwm11_scalar_temp++;
+			}
+		}
+
+		pwm11_ratio_fx >>= 2;
+		pwm11_prescalar += 2;
+	}
+
+
+	if (pwm11_scalar == 0)
+	{
+		pwm11_counter  = 2047;
+		pwm11_scalar   = 32;
+		pwm11_best_pre = 6;
+	}
+
+
+	// Convert shifts into prescaler value
+	if 		(pwm11_best_pre == 0)	{pwm11_prescalar = 1;}	// 0b00
+	else if	(pwm11_best_pre == 2)	{pwm11_prescalar = 4;}	// 0b01
+	else if (pwm11_best_pre == 4)	{pwm11_prescalar = 16;}	// 0b10
+	else							{pwm11_prescalar = 64;}	// 0b11
+
+	pwm11_scalar--;		// Decrement scalar to compensate for +1 in formula
+	pwm11_counter--;	// Decrement counter to compensate for +1 in formula
+}
+
+#ELSE
+
 static void Solve_PWM_Parameters(void)
 {
 	if (!pwm11_target_freq) pwm11_target_freq = (pwm11_clk_freq >> 4);
 
+	#IF PWM_SOLVER_REPORT
+		pwm11_actual_freq = pwm11_target_freq;	// Target, kept for PWM11_Report
+	#ENDIF
+
 	// Find ratio between clk freq and desired pwm freq
 	math_dividend = pwm11_clk_freq;
 	math_divisor  = pwm11_target_freq;
@@ -167,26 +626,47 @@ static void Solve_PWM_Parameters(void)
 	else if (pwm11_prescalar == 6)	{pwm11_prescalar = 64;}	// 0b11
 
 
-	// Scan through scalar values to find optimal solution
-	pwm11_scalar_temp = 1; 
-	pwm11_tolerance = 32;
-	do
+	// Leftover counts allowed by pwm11_solve_ppm, ratio x ppm / 2^20.
+	// 2^20 is used for 10^6, so the limit is ~5% tighter than asked.
+	pwm11_solve_tol = 0;
+	if (pwm11_solve_ppm)
+	{
+		math_mult_a = pwm11_clock_ratio;
+		math_mult_b = pwm11_solve_ppm;
+		word_multiply();
+		math_product >>= 4;
+
+		if (math_product$3) pwm11_solve_tol = 0xFF;
+		else                pwm11_solve_tol = math_product$2;
+	}
+
+
+	// Scan scalars for the smallest leftover with an odd counter below 2048.
+	// Scalars below ratio / 2048 + 1 give a counter above 2047 and are skipped,
+	// and the scan stops at the first exact result. Ties keep the smaller scalar.
+	pwm11_counter     = 0;
+	pwm11_scalar      = 0;
+	pwm11_tolerance   = 32;
+	pwm11_scalar_temp = pwm11_clock_ratio$1 >> 3;
+	pwm11_scalar_temp++;
+	if (pwm11_clock_ratio$2) pwm11_scalar_temp = 33;	// Below range even at prescaler 64
+
+	// To update, counter must be odd and tolerance must improve
+	while (pwm11_scalar_temp < 33)
 	{
-		math_dividend = pwm11_clock_ratio;
-		math_divisor  = pwm11_scalar_temp;
-		word_divide();
+		Divide_Scalar();
 
-		// To update, counter must be odd, less than 2^11, and tolerance must improve
-		if ((math_remainder < pwm11_tolerance) && math_quotient.0 && (math_quotient < 2048))
+		if ((pwm11_leftover < pwm11_tolerance) && math_mult_b.0)
 		{
-			pwm11_tolerance = math_remainder;
-			pwm11_counter = math_quotient;
-			pwm11_scalar = pwm11_scalar_temp;
+			pwm11_tolerance = pwm11_leftover;
+			pwm11_counter   = math_mult_b;
+			pwm11_scalar    = pwm11_scalar_temp;
+
+			if (pwm11_tolerance <= pwm11_solve_tol) break;	// Exact, or good enough
 		}
 
 		pwm11_scalar_temp++;
-
-	} while (pwm11_scalar_temp < 33);
+	}
 
 	if ((pwm11_counter == 0) || (pwm11_scalar == 0))
 	{
@@ -199,6 +679,9 @@ static void Solve_PWM_Parameters(void)
 }
 
 
+#ENDIF // PWM_SOLVE_GLOBAL
+
+
 static void Solve_Duty(void)
 {
 	if (pwm11_duty_percent > 100) pwm11_duty_percent = 50;
@@ -208,8 +691,7 @@ static void Solve_Duty(void)
 	word_multiply();
 
 	math_dividend = math_product;
-	math_divisor = 100;
-	eword_divide();
+	Eword_Divide_Const (100);
 
 	pwm11_duty = math_quotient;
 	math_remainder -= 50;
@@ -217,200 +699,358 @@ static void Solve_Duty(void)
 	if (math_remainder > 50) pwm11_duty.0 = 1;
 	else pwm11_duty.0 = 0;
 }
-#ENDIF //PWM_SOLVER_ENABLE
 
 
-static void Convert_Prescalar(void)
-{
-	if 		(pwm11_prescalar == 4) 	pwm11_prescalar = 0b0100000;
-	else if (pwm11_prescalar == 16) pwm11_prescalar = 0b1000000;
-	else if (pwm11_prescalar == 64)	pwm11_prescalar = 0b1100000;
-	else							pwm11_prescalar = 0b0000000;
-}
-
+#IF PWM_SOLVER_REPORT
 
-//===================//
-// PROGRAM FUNCTIONS //
-//===================//
-
-
-// PWM 0
-
-void PWM11_0_Stop (void)
-{ 
-	if (pwm11_pwm0_init) $ PWM_0_CTL PWM_0_POL, PWM_0_OUTPUT, PWM_0_CLOCK; 
-}
-
-
-void PWM11_0_Start (void)
-{ 
-	if (pwm11_pwm0_init) $ PWM_0_CTL PWM_ENABLE, PWM_RESET, PWM_0_POL, PWM_0_OUTPUT, PWM_0_CLOCK; 
-}
-
-
-void PWM11_0_Set_Parameters(void)
+// Achieved frequency and ppm error of the solved registers.
+// Expects pwm11_clk_freq = PWM clock and pwm11_actual_freq = target.
+static void PWM11_Report(void)
 {
-	if (pwm11_pwm0_init)
-	{
-		#IF PWM_SOLVER_ENABLE
-			if (pwm11_use_solver)
-			{
-				pwm11_clk_freq = PWM_0_CLK_HZ;
-				Solve_PWM_Parameters();	
-				Solve_Duty();
-			}
-		#ENDIF
-
-		Convert_Prescalar();
-
-		PWM_0_SCALAR = pwm11_prescalar | pwm11_scalar | PWM_0_INT;
-
-		pwm11_duty <<= 5;
-		PWM_0_DUTY_L = pwm11_duty$0;
-		PWM_0_DUTY_H = pwm11_duty$1;
-
-		pwm11_counter <<= 5;
-		PWM_0_COUNT_L = pwm11_counter$0;
-		PWM_0_COUNT_H = pwm11_counter$1;
-	}
-}
-
-
-void PWM11_0_Initialize (void)
-{
-	if (!pwm11_pwm0_init && PWM_USE_G0)
-	{
-		PWM11_0_Stop();
-		pwm11_pwm0_init = 1;
-	}
-}
-
-
-void PWM11_0_Release (void)
-{
-	if (pwm11_pwm0_init)
-	{
-		PWM11_0_Stop();
-		pwm11_pwm0_init = 0;
-	}
-}
-
-
+	// Prescaled clocks per period, P x (S + 1) x (C + 1), before the x2 correction
+	math_mult_a = pwm11_prescalar;
+	math_mult_b = pwm11_scalar + 1;
+	word_multiply();
 
-// PWM 1
+	math_mult_a = math_product;
+	math_mult_b = pwm11_counter + 1;
+	word_multiply();
 
-void PWM11_1_Stop (void)
-{ if (pwm11_pwm1_init) $ PWM_1_CTL PWM_1_POL, PWM_1_OUTPUT, PWM_1_CLOCK; }
 
+	// Achieved Hz, rounded. Clock is doubled, see DOCUMENTATION ERROR.
+	math_divisor   = math_product;
+	math_dividend  = math_divisor;
+	math_dividend >>= 1;
+	math_dividend += pwm11_clk_freq;
+	math_dividend += pwm11_clk_freq;
+	dword_divide();
 
-void PWM11_1_Start (void)
-{ if (pwm11_pwm1_init) $ PWM_1_CTL PWM_ENABLE, PWM_RESET, PWM_1_POL, PWM_1_OUTPUT, PWM_1_CLOCK; }
+	math_mult_db      = pwm11_actual_freq;
+	pwm11_actual_freq = math_quotient;
 
 
-void PWM11_1_Set_Parameters(void)
-{
-	if (pwm11_pwm1_init)
+	// Error against target x clocks per period. math_mult_da still holds the clocks.
+	eword_multiply();
+	if (math_product_h) pwm11_error_ppm = 0xFFFFFF;
+	else
 	{
-		#IF PWM_SOLVER_ENABLE
-			if (pwm11_use_solver)
-			{
-				pwm11_clk_freq = PWM_1_CLK_HZ;
-				Solve_PWM_Parameters();	
-				Solve_Duty();
-			}
-		#ENDIF
-
-		Convert_Prescalar();
-
-		PWM_1_SCALAR = pwm11_prescalar | pwm11_scalar | PWM_1_INT;
-
-		pwm11_duty <<= 5;
-		PWM_1_DUTY_L = pwm11_duty$0;
-		PWM_1_DUTY_H = pwm11_duty$1;
-
-		pwm11_counter <<= 5;
-		PWM_1_COUNT_L = pwm11_counter$0;
-		PWM_1_COUNT_H = pwm11_counter$1;
+		math_mult_db  = math_product;
+		math_mult_da  = pwm11_clk_freq;
+		math_mult_da += pwm11_clk_freq;
+		ppm_error();
+		pwm11_error_ppm = math_quotient;
 	}
 }
 
+#ENDIF
 
-void PWM11_1_Initialize (void)
-{
-	if (!pwm11_pwm1_init && PWM_USE_G1)
-	{
-		PWM11_1_Stop();
-		pwm11_pwm1_init = 1;
-	}
-}
+#ENDIF //PWM_SOLVER_ENABLE
 
 
-void PWM11_1_Release (void)
+static void Convert_Prescalar(void)
 {
-	if (pwm11_pwm1_init)
-	{
-		PWM11_1_Stop();
-		pwm11_pwm1_init = 0;
-	}
+	if 		(pwm11_prescalar == 4) 	pwm11_prescalar = 0b0100000;
+	else if (pwm11_prescalar == 16) pwm11_prescalar = 0b1000000;
+	else if (pwm11_prescalar == 64)	pwm11_prescalar = 0b1100000;
+	else							pwm11_prescalar = 0b0000000;
 }
 
 
+//===================//
+// PROGRAM FUNCTIONS //
+//===================//
 
-// PWM 2
-
-void PWM11_2_Stop (void)
-{ if (pwm11_pwm2_init) $ PWM_2_CTL PWM_2_POL, PWM_2_OUTPUT, PWM_2_CLOCK; }
 
+// PWM 0
 
-void PWM11_2_Start (void)
-{ if (pwm11_pwm2_init) $ PWM_2_CTL PWM_ENABLE, PWM_RESET, PWM_2_POL, PWM_2_OUTPUT, PWM_2_CLOCK; }
+#IF PWM_USE_G0
+
+	#define PWMG_CTL                 PWM_0_CTL
+	#define PWMG_SCALAR              PWM_0_SCALAR
+	#define PWMG_DUTY_L              PWM_0_DUTY_L
+	#define PWMG_DUTY_H              PWM_0_DUTY_H
+	#define PWMG_COUNT_L             PWM_0_COUNT_L
+	#define PWMG_COUNT_H             PWM_0_COUNT_H
+	#define PWMG_POL                 PWM_0_POL
+	#define PWMG_OUTPUT              PWM_0_OUTPUT
+	#define PWMG_CLOCK               PWM_0_CLOCK
+	#define PWMG_INT                 PWM_0_INT
+	#define PWMG_CLK_HZ              PWM_0_CLK_HZ
+	#define PWMG_TARGET              PWM_0_TARGET
+	#define PWMG_BUILD_PRE           PWM_0_BUILD_PRE
+	#define PWMG_BUILD_SCL           PWM_0_BUILD_SCL
+	#define PWMG_BUILD_DUTY          PWM_0_BUILD_DUTY
+	#define PWMG_BUILD_CNT           PWM_0_BUILD_CNT
+	#define PWMG_PRESETS             PWM_0_PRESETS
+
+	#define PWMG_INIT                pwm11_pwm0_init
+	#define PWMG_PENDING             pwm11_g0_pending
+	#define PWMG_NEXT_SCL            pwm11_g0_next_scl
+	#define PWMG_NEXT_DUTY           pwm11_g0_next_duty
+	#define PWMG_NEXT_CNT            pwm11_g0_next_cnt
+	#define PWMG_DTH_ACC             pwm11_g0_dth_acc
+	#define PWMG_DTH_FRAC            pwm11_g0_dth_frac
+	#define PWMG_DTH_TOP             pwm11_g0_dth_top
+	#define PWMG_DTH_LO              pwm11_g0_dth_lo
+	#define PWMG_DTH_HI              pwm11_g0_dth_hi
+
+	#define PWMG_STOP                PWM11_0_Stop
+	#define PWMG_START               PWM11_0_Start
+	#define PWMG_LOAD                PWM11_0_Load
+	#define PWMG_SET_PARAMETERS      PWM11_0_Set_Parameters
+	#define PWMG_INITIALIZE          PWM11_0_Initialize
+	#define PWMG_RELEASE             PWM11_0_Release
+	#define PWMG_APPLY_PRESET        PWM11_0_Apply_Preset
+	#define PWMG_COMMIT              PWM11_0_Commit
+	#define PWMG_PRESET_SCL          PWM11_0_Preset_Scl
+	#define PWMG_PRESET_CNT_L        PWM11_0_Preset_Cnt_L
+	#define PWMG_PRESET_CNT_H        PWM11_0_Preset_Cnt_H
+	#define PWMG_PRESET_DUTY_L       PWM11_0_Preset_Duty_L
+	#define PWMG_PRESET_DUTY_H       PWM11_0_Preset_Duty_H
+	#define PWMG_SET_DUTY16          PWM11_0_Set_Duty16
+	#define PWMG_DITHER              PWM11_0_Dither
+
+	#include "pdk_pwm_11b.inc"
+
+	#undef  PWMG_CTL
+	#undef  PWMG_SCALAR
+	#undef  PWMG_DUTY_L
+	#undef  PWMG_DUTY_H
+	#undef  PWMG_COUNT_L
+	#undef  PWMG_COUNT_H
+	#undef  PWMG_POL
+	#undef  PWMG_OUTPUT
+	#undef  PWMG_CLOCK
+	#undef  PWMG_INT
+	#undef  PWMG_CLK_HZ
+	#undef  PWMG_TARGET
+	#undef  PWMG_BUILD_PRE
+	#undef  PWMG_BUILD_SCL
+	#undef  PWMG_BUILD_DUTY
+	#undef  PWMG_BUILD_CNT
+	#undef  PWMG_PRESETS
+	#undef  PWMG_INIT
+	#undef  PWMG_PENDING
+	#undef  PWMG_NEXT_SCL
+	#undef  PWMG_NEXT_DUTY
+	#undef  PWMG_NEXT_CNT
+	#undef  PWMG_DTH_ACC
+	#undef  PWMG_DTH_FRAC
+	#undef  PWMG_DTH_TOP
+	#undef  PWMG_DTH_LO
+	#undef  PWMG_DTH_HI
+	#undef  PWMG_STOP
+	#undef  PWMG_START
+	#undef  PWMG_LOAD
+	#undef  PWMG_SET_PARAMETERS
+	#undef  PWMG_INITIALIZE
+	#undef  PWMG_RELEASE
+	#undef  PWMG_APPLY_PRESET
+	#undef  PWMG_COMMIT
+	#undef  PWMG_PRESET_SCL
+	#undef  PWMG_PRESET_CNT_L
+	#undef  PWMG_PRESET_CNT_H
+	#undef  PWMG_PRESET_DUTY_L
+	#undef  PWMG_PRESET_DUTY_H
+	#undef  PWMG_SET_DUTY16
+	#undef  PWMG_DITHER
+
+#ENDIF // PWM_USE_G0
 
 
-void PWM11_2_Set_Parameters(void)
-{
-	if (pwm11_pwm2_init)
-	{
-		#IF PWM_SOLVER_ENABLE
-			if (pwm11_use_solver)
-			{
-				pwm11_clk_freq = PWM_2_CLK_HZ;
-				Solve_PWM_Parameters();	
-				Solve_Duty();
-			}
-		#ENDIF
-
-		Convert_Prescalar();
 
-		PWM_2_SCALAR = pwm11_prescalar | pwm11_scalar | PWM_2_INT;
-
-		pwm11_duty <<= 5;
-		PWM_2_DUTY_L = pwm11_duty$0;
-		PWM_2_DUTY_H = pwm11_duty$1;
+// PWM 1
 
-		pwm11_counter <<= 5;
-		PWM_2_COUNT_L = pwm11_counter$0;
-		PWM_2_COUNT_H = pwm11_counter$1;
-	}
-}
+#IF PWM_USE_G1
+
+	#define PWMG_CTL                 PWM_1_CTL
+	#define PWMG_SCALAR              PWM_1_SCALAR
+	#define PWMG_DUTY_L              PWM_1_DUTY_L
+	#define PWMG_DUTY_H              PWM_1_DUTY_H
+	#define PWMG_COUNT_L             PWM_1_COUNT_L
+	#define PWMG_COUNT_H             PWM_1_COUNT_H
+	#define PWMG_POL                 PWM_1_POL
+	#define PWMG_OUTPUT              PWM_1_OUTPUT
+	#define PWMG_CLOCK               PWM_1_CLOCK
+	#define PWMG_INT                 PWM_1_INT
+	#define PWMG_CLK_HZ              PWM_1_CLK_HZ
+	#define PWMG_TARGET              PWM_1_TARGET
+	#define PWMG_BUILD_PRE           PWM_1_BUILD_PRE
+	#define PWMG_BUILD_SCL           PWM_1_BUILD_SCL
+	#define PWMG_BUILD_DUTY          PWM_1_BUILD_DUTY
+	#define PWMG_BUILD_CNT           PWM_1_BUILD_CNT
+	#define PWMG_PRESETS             PWM_1_PRESETS
+
+	#define PWMG_INIT                pwm11_pwm1_init
+	#define PWMG_PENDING             pwm11_g1_pending
+	#define PWMG_NEXT_SCL            pwm11_g1_next_scl
+	#define PWMG_NEXT_DUTY           pwm11_g1_next_duty
+	#define PWMG_NEXT_CNT            pwm11_g1_next_cnt
+	#define PWMG_DTH_ACC             pwm11_g1_dth_acc
+	#define PWMG_DTH_FRAC            pwm11_g1_dth_frac
+	#define PWMG_DTH_TOP             pwm11_g1_dth_top
+	#define PWMG_DTH_LO              pwm11_g1_dth_lo
+	#define PWMG_DTH_HI              pwm11_g1_dth_hi
+
+	#define PWMG_STOP                PWM11_1_Stop
+	#define PWMG_START               PWM11_1_Start
+	#define PWMG_LOAD                PWM11_1_Load
+	#define PWMG_SET_PARAMETERS      PWM11_1_Set_Parameters
+	#define PWMG_INITIALIZE          PWM11_1_Initialize
+	#define PWMG_RELEASE             PWM11_1_Release
+	#define PWMG_APPLY_PRESET        PWM11_1_Apply_Preset
+	#define PWMG_COMMIT              PWM11_1_Commit
+	#define PWMG_PRESET_SCL          PWM11_1_Preset_Scl
+	#define PWMG_PRESET_CNT_L        PWM11_1_Preset_Cnt_L
+	#define PWMG_PRESET_CNT_H        PWM11_1_Preset_Cnt_H
+	#define PWMG_PRESET_DUTY_L       PWM11_1_Preset_Duty_L
+	#define PWMG_PRESET_DUTY_H       PWM11_1_Preset_Duty_H
+	#define PWMG_SET_DUTY16          PWM11_1_Set_Duty16
+	#define PWMG_DITHER              PWM11_1_Dither
+
+	#include "pdk_pwm_11b.inc"
+
+	#undef  PWMG_CTL
+	#undef  PWMG_SCALAR
+	#undef  PWMG_DUTY_L
+	#undef  PWMG_DUTY_H
+	#undef  PWMG_COUNT_L
+	#undef  PWMG_COUNT_H
+	#undef  PWMG_POL
+	#undef  PWMG_OUTPUT
+	#undef  PWMG_CLOCK
+	#undef  PWMG_INT
+	#undef  PWMG_CLK_HZ
+	#undef  PWMG_TARGET
+	#undef  PWMG_BUILD_PRE
+	#undef  PWMG_BUILD_SCL
+	#undef  PWMG_BUILD_DUTY
+	#undef  PWMG_BUILD_CNT
+	#undef  PWMG_PRESETS
+	#undef  PWMG_INIT
+	#undef  PWMG_PENDING
+	#undef  PWMG_NEXT_SCL
+	#undef  PWMG_NEXT_DUTY
+	#undef  PWMG_NEXT_CNT
+	#undef  PWMG_DTH_ACC
+	#undef  PWMG_DTH_FRAC
+	#undef  PWMG_DTH_TOP
+	#undef  PWMG_DTH_LO
+	#undef  PWMG_DTH_HI
+	#undef  PWMG_STOP
+	#undef  PWMG_START
+	#undef  PWMG_LOAD
+	#undef  PWMG_SET_PARAMETERS
+	#undef  PWMG_INITIALIZE
+	#undef  PWMG_RELEASE
+	#undef  PWMG_APPLY_PRESET
+	#undef  PWMG_COMMIT
+	#undef  PWMG_PRESET_SCL
+	#undef  PWMG_PRESET_CNT_L
+	#undef  PWMG_PRESET_CNT_H
+	#undef  PWMG_PRESET_DUTY_L
+	#undef  PWMG_PRESET_DUTY_H
+	#undef  PWMG_SET_DUTY16
+	#undef  PWMG_DITHER
+
+#ENDIF // PWM_USE_G1
 
 
-void PWM11_2_Initialize (void)
-{
-	if (!pwm11_pwm2_init && PWM_USE_G2)
-	{
-		PWM11_2_Stop();
-		pwm11_pwm2_init = 1;
-	}
-}
 
+// PWM 2
 
-void PWM11_2_Release (void)
-{
-	if (pwm11_pwm2_init)
-	{
-		PWM11_2_Stop();
-		pwm11_pwm1_init = 0;
-	}
-}
+#IF PWM_USE_G2
+
+	#define PWMG_CTL                 PWM_2_CTL
+	#define PWMG_SCALAR              PWM_2_SCALAR
+	#define PWMG_DUTY_L              PWM_2_DUTY_L
+	#define PWMG_DUTY_H              PWM_2_DUTY_H
+	#define PWMG_COUNT_L             PWM_2_COUNT_L
+	#define PWMG_COUNT_H             PWM_2_COUNT_H
+	#define PWMG_POL                 PWM_2_POL
+	#define PWMG_OUTPUT              PWM_2_OUTPUT
+	#define PWMG_CLOCK               PWM_2_CLOCK
+	#define PWMG_INT                 PWM_2_INT
+	#define PWMG_CLK_HZ              PWM_2_CLK_HZ
+	#define PWMG_TARGET              PWM_2_TARGET
+	#define PWMG_BUILD_PRE           PWM_2_BUILD_PRE
+	#define PWMG_BUILD_SCL           PWM_2_BUILD_SCL
+	#define PWMG_BUILD_DUTY          PWM_2_BUILD_DUTY
+	#define PWMG_BUILD_CNT           PWM_2_BUILD_CNT
+	#define PWMG_PRESETS             PWM_2_PRESETS
+
+	#define PWMG_INIT                pwm11_pwm2_init
+	#define PWMG_PENDING             pwm11_g2_pending
+	#define PWMG_NEXT_SCL            pwm11_g2_next_scl
+	#define PWMG_NEXT_DUTY           pwm11_g2_next_duty
+	#define PWMG_NEXT_CNT            pwm11_g2_next_cnt
+	#define PWMG_DTH_ACC             pwm11_g2_dth_acc
+	#define PWMG_DTH_FRAC            pwm11_g2_dth_frac
+	#define PWMG_DTH_TOP             pwm11_g2_dth_top
+	#define PWMG_DTH_LO              pwm11_g2_dth_lo
+	#define PWMG_DTH_HI              pwm11_g2_dth_hi
+
+	#define PWMG_STOP                PWM11_2_Stop
+	#define PWMG_START               PWM11_2_Start
+	#define PWMG_LOAD                PWM11_2_Load
+	#define PWMG_SET_PARAMETERS      PWM11_2_Set_Parameters
+	#define PWMG_INITIALIZE          PWM11_2_Initialize
+	#define PWMG_RELEASE             PWM11_2_Release
+	#define PWMG_APPLY_PRESET        PWM11_2_Apply_Preset
+	#define PWMG_COMMIT              PWM11_2_Commit
+	#define PWMG_PRESET_SCL          PWM11_2_Preset_Scl
+	#define PWMG_PRESET_CNT_L        PWM11_2_Preset_Cnt_L
+	#define PWMG_PRESET_CNT_H        PWM11_2_Preset_Cnt_H
+	#define PWMG_PRESET_DUTY_L       PWM11_2_Preset_Duty_L
+	#define PWMG_PRESET_DUTY_H       PWM11_2_Preset_Duty_H
+	#define PWMG_SET_DUTY16          PWM11_2_Set_Duty16
+	#define PWMG_DITHER              PWM11_2_Dither
+
+	#include "pdk_pwm_11b.inc"
+
+	#undef  PWMG_CTL
+	#undef  PWMG_SCALAR
+	#undef  PWMG_DUTY_L
+	#undef  PWMG_DUTY_H
+	#undef  PWMG_COUNT_L
+	#undef  PWMG_COUNT_H
+	#undef  PWMG_POL
+	#undef  PWMG_OUTPUT
+	#undef  PWMG_CLOCK
+	#undef  PWMG_INT
+	#undef  PWMG_CLK_HZ
+	#undef  PWMG_TARGET
+	#undef  PWMG_BUILD_PRE
+	#undef  PWMG_BUILD_SCL
+	#undef  PWMG_BUILD_DUTY
+	#undef  PWMG_BUILD_CNT
+	#undef  PWMG_PRESETS
+	#undef  PWMG_INIT
+	#undef  PWMG_PENDING
+	#undef  PWMG_NEXT_SCL
+	#undef  PWMG_NEXT_DUTY
+	#undef  PWMG_NEXT_CNT
+	#undef  PWMG_DTH_ACC
+	#undef  PWMG_DTH_FRAC
+	#undef  PWMG_DTH_TOP
+	#undef  PWMG_DTH_LO
+	#undef  PWMG_DTH_HI
+	#undef  PWMG_STOP
+	#undef  PWMG_START
+	#undef  PWMG_LOAD
+	#undef  PWMG_SET_PARAMETERS
+	#undef  PWMG_INITIALIZE
+	#undef  PWMG_RELEASE
+	#undef  PWMG_APPLY_PRESET
+	#undef  PWMG_COMMIT
+	#undef  PWMG_PRESET_SCL
+	#undef  PWMG_PRESET_CNT_L
+	#undef  PWMG_PRESET_CNT_H
+	#undef  PWMG_PRESET_DUTY_L
+	#undef  PWMG_PRESET_DUTY_H
+	#undef  PWMG_SET_DUTY16
+	#undef  PWMG_DITHER
+
+#ENDIF // PWM_USE_G2
 
 #ENDIF \\ PERIPH_PWM_11B
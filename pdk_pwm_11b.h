@@ -27,6 +27,23 @@ NOTE:
 	computation times and a 100x performance improvement at the expense of memory and slightly
 	inferior error rates. Error rate might be reduced by multiplying Clk x2 instead of clock
 	ratio. This would require DWORD division, which currently does not exist.
+
+	When PWM_0_TARGET / PWM_1_TARGET / PWM_2_TARGET is set in system_settings.h,
+	that generator is solved at build time and Set_Parameters only writes registers.
+	pwm11_use_solver and the pwm11_* parameters are ignored for that generator.
+	With every used generator solved at build time, PWM_SOLVER_ENABLE can be set
+	to 0 to drop the solver and the math library.
+
+	LIVE UPDATE: Start issues a PWM reset, so calling Stop/Set/Start on a
+	running generator cuts the current period short. With PWM_LIVE_UPDATE
+	enabled and pwm11_live_update set, Set_Parameters and Apply_Preset only
+	stage the new registers. PWM11_X_Commit loads them without a reset and
+	should run once per period. Only G0 has an interrupt; G1/G2 can commit
+	from it when they share its period, or from a timer tied to their period.
+
+	DITHER: With PWM_DITHER set, PWM11_X_Set_Duty16 takes a 16-bit duty in
+	pwm11_duty16 and PWM11_X_Dither, called once per period from INTR_PWM,
+	spreads the part below one counter step over periods. See pdk_pwm_11b.c.
 		
 	
 	In the PMS132 datasheet frequency can be solved with the following equation:
@@ -54,7 +71,10 @@ EXTERN BYTE	pwm11_prescalar;		// 6-bit  [1, 4, 16, 64]
 EXTERN WORD	pwm11_scalar;			// 5-bit  [0 : 31]
 EXTERN WORD	pwm11_counter;		// 11-bit [0 : 2046] in steps of 2
 EXTERN WORD	pwm11_duty;			// 11-bit [0 : 2047]
+EXTERN BYTE	pwm11_preset;			// ROM preset index, see tools/preset_gen.cpp
 EXTERN BIT  pwm11_use_solver;
+EXTERN BIT  pwm11_live_update;		// PWM_LIVE_UPDATE only. Stage for PWM11_X_Commit
+EXTERN WORD	pwm11_duty16;			// PWM_DITHER only. [0 : 65535] is [0 : 100%)
 
 
 //======================//
@@ -65,6 +85,12 @@ EXTERN BIT  pwm11_use_solver;
 
 EXTERN BYTE  &pwm11_duty_percent;
 EXTERN EWORD &pwm11_target_freq;	// Hz
+EXTERN WORD   pwm11_solve_ppm;		// 0: Best result, other: Stop at first result within ppm
+
+#IF PWM_SOLVER_REPORT
+EXTERN EWORD  pwm11_actual_freq;	// Hz achieved by the last solve
+EXTERN EWORD  pwm11_error_ppm;		// |actual - target| / target x 10^6, 0xFFFFFF max
+#ENDIF
 
 #ENDIF
 #ENDIF //PERIPH_PWM_11B
@@ -78,15 +104,27 @@ void	PWM11_0_Set_Parameters (void);
 void	PWM11_0_Start          (void);
 void	PWM11_0_Stop           (void);
 void	PWM11_0_Release        (void);
+void	PWM11_0_Apply_Preset   (void); // PWM_0_PRESETS > 0 only
+void	PWM11_0_Commit         (void); // PWM_LIVE_UPDATE only, once per period
+void	PWM11_0_Set_Duty16     (void); // PWM_DITHER only
+void	PWM11_0_Dither         (void); // PWM_DITHER only, once per period
 
 void	PWM11_1_Initialize     (void);
 void	PWM11_1_Set_Parameters (void);
 void	PWM11_1_Start          (void);
 void	PWM11_1_Stop           (void);
 void	PWM11_1_Release        (void);
+void	PWM11_1_Apply_Preset   (void); // PWM_1_PRESETS > 0 only
+void	PWM11_1_Commit         (void); // PWM_LIVE_UPDATE only, once per period
+void	PWM11_1_Set_Duty16     (void); // PWM_DITHER only
+void	PWM11_1_Dither         (void); // PWM_DITHER only, once per period
 
 void	PWM11_2_Initialize     (void);
 void	PWM11_2_Set_Parameters (void);
 void	PWM11_2_Start          (void);
 void	PWM11_2_Stop           (void);
 void	PWM11_2_Release        (void);
+void	PWM11_2_Apply_Preset   (void); // PWM_2_PRESETS > 0 only
+void	PWM11_2_Commit         (void); // PWM_LIVE_UPDATE only, once per period
+void	PWM11_2_Set_Duty16     (void); // PWM_DITHER only
+void	PWM11_2_Dither         (void); // PWM_DITHER only, once per period
@@ -150,14 +150,21 @@ void Stepper_Set_Vel (void)
 		math_mult_b = stepper_steps_per_rev;
 		word_multiply();
 
-		math_divisor = 60;
 		math_dividend = math_product;
-		dword_divide();
-
-		math_dividend = math_quotient;
 		math_divisor = stepper_units_per_rev;
 		dword_divide();
 
+		// floor(floor(a / b) / 60) == floor(a / (b x 60))
+		if (math_quotient$3)
+		{
+			math_divisor = 60;
+			dword_divide();
+		}
+		else
+		{
+			Eword_Divide_Const (60);
+		}
+
 		target_freq = math_quotient;
 
 		if (!target_freq) target_freq = 1;
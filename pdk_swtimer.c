@@ -0,0 +1,379 @@
+/* pdk_swtimer.c
+
+Software timer wheel. SWT_COUNT virtual one-shot or periodic timers run
+from one hardware timer interrupt. Define PERIPH_SWTIMER in system_settings.h
+
+ROM Consumed : 338B / 0x152
+RAM Consumed :  23B / 0x17  +  5B per virtual timer
+
+
+NOTE:
+
+	Timers are kept in a delta queue sorted by expiry. Each entry holds the
+	ticks remaining after the entry in front of it, so a tick only touches
+	the head entry. Timers that expire on the same tick are popped together
+	and periodic timers are queued again with their reload value.
+
+	Expiry sets the timer's bit in swt_expired. The compiler cannot call
+	through function pointers, so the user program checks the bit in the
+	main loop, clears it and runs its handler there:
+
+		if (swt_expired.MY_TIMER) { swt_expired.MY_TIMER = 0; ... }
+
+	Place SWT_Tick_Interrupt under the SWT_INTR flag in the Interrupt
+	function. SWT_Start and SWT_Stop briefly clear INTEN and restore it on
+	return. The global interrupt enable is left as the caller had it.
+
+	Ticks are counted from the next tick interrupt, so a timer can fire up
+	to 1 tick early. Add 1 tick when a minimum delay matters.
+
+	SWT_Start on a running timer restarts it with the new ticks/period.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+#include "system_settings.h"
+
+#IF PERIPH_SWTIMER
+
+//======================//
+// VARIABLES AND MACROS //
+//======================//
+
+BYTE swt_flags = 0;
+BIT  swt_module_initialized : swt_flags.?;
+
+BYTE swt_id      = 0;
+WORD swt_ticks   = 0;
+WORD swt_period  = 0;
+BYTE swt_expired = 0;
+BYTE swt_running = 0;
+
+
+// Queue, one slot per virtual timer
+STATIC BYTE swt_head = 0xFF;
+STATIC BYTE swt_next     [SWT_COUNT];
+STATIC BYTE swt_delta_l  [SWT_COUNT];
+STATIC BYTE swt_delta_h  [SWT_COUNT];
+STATIC BYTE swt_reload_l [SWT_COUNT];
+STATIC BYTE swt_reload_h [SWT_COUNT];
+
+
+// Working registers. Shared with the interrupt, so the program functions
+// run with INTEN cleared. swt_inten holds the caller's INTEN meanwhile.
+STATIC BYTE swt_inten;
+STATIC WORD swt_ptr;
+STATIC WORD swt_value;
+STATIC WORD swt_remain;
+STATIC BYTE swt_index;
+STATIC BYTE swt_target;
+STATIC BYTE swt_prev;
+STATIC BYTE swt_link;
+STATIC BYTE swt_mask;
+STATIC BYTE swt_count;
+
+
+// End of queue marker
+SWT_END       =>  0xFF;
+
+// Number of counts between tick interrupts
+SWT_BOUND     =>  SWT_TICK_BND;	// Range checked in system_settings.h
+
+
+//==================//
+// STATIC FUNCTIONS //
+//==================//
+
+// swt_mask = 1 << swt_index
+static void SWT_Mask(void)
+{
+	swt_mask  = 1;
+	swt_count = swt_index;
+	while (swt_count)
+	{
+		swt_mask <<= 1;
+		swt_count--;
+	}
+}
+
+
+// swt_value = delta[swt_index]
+static void SWT_Get_Delta(void)
+{
+	swt_ptr      = swt_delta_l;
+	swt_ptr     += swt_index;
+	swt_value$0  = *swt_ptr;
+	swt_ptr      = swt_delta_h;
+	swt_ptr     += swt_index;
+	swt_value$1  = *swt_ptr;
+}
+
+
+// delta[swt_index] = swt_value
+static void SWT_Set_Delta(void)
+{
+	swt_ptr   = swt_delta_l;
+	swt_ptr  += swt_index;
+	*swt_ptr  = swt_value$0;
+	swt_ptr   = swt_delta_h;
+	swt_ptr  += swt_index;
+	*swt_ptr  = swt_value$1;
+}
+
+
+// swt_value = reload[swt_index]
+static void SWT_Get_Reload(void)
+{
+	swt_ptr      = swt_reload_l;
+	swt_ptr     += swt_index;
+	swt_value$0  = *swt_ptr;
+	swt_ptr      = swt_reload_h;
+	swt_ptr     += swt_index;
+	swt_value$1  = *swt_ptr;
+}
+
+
+// reload[swt_index] = swt_value
+static void SWT_Set_Reload(void)
+{
+	swt_ptr   = swt_reload_l;
+	swt_ptr  += swt_index;
+	*swt_ptr  = swt_value$0;
+	swt_ptr   = swt_reload_h;
+	swt_ptr  += swt_index;
+	*swt_ptr  = swt_value$1;
+}
+
+
+// swt_link = next[swt_index]
+static void SWT_Get_Next(void)
+{
+	swt_ptr   = swt_next;
+	swt_ptr  += swt_index;
+	swt_link  = *swt_ptr;
+}
+
+
+// next[swt_index] = swt_link
+static void SWT_Set_Next(void)
+{
+	swt_ptr   = swt_next;
+	swt_ptr  += swt_index;
+	*swt_ptr  = swt_link;
+}
+
+
+// Queue timer swt_index to expire swt_value ticks from now
+static void SWT_Insert(void)
+{
+	swt_target = swt_index;
+	swt_remain = swt_value;
+	swt_prev   = SWT_END;
+	swt_index  = swt_head;
+
+	// Walk past every entry that expires first. Equal expiries stay in start order.
+	while (swt_index != SWT_END)
+	{
+		SWT_Get_Delta();
+		if (swt_remain < swt_value) break;
+		swt_remain -= swt_value;
+		swt_prev    = swt_index;
+		SWT_Get_Next();
+		swt_index   = swt_link;
+	}
+
+	// Entry behind the new timer now counts from the new timer
+	if (swt_index != SWT_END)
+	{
+		SWT_Get_Delta();
+		swt_value -= swt_remain;
+		SWT_Set_Delta();
+	}
+
+	swt_link  = swt_index;
+	swt_index = swt_target;
+	SWT_Set_Next();
+	swt_value = swt_remain;
+	SWT_Set_Delta();
+
+	if (swt_prev == SWT_END) swt_head = swt_target;
+	else
+	{
+		swt_link  = swt_target;
+		swt_index = swt_prev;
+		SWT_Set_Next();
+		swt_index = swt_target;
+	}
+
+	SWT_Mask();
+	swt_running = swt_running | swt_mask;
+}
+
+
+// Take timer swt_index out of the queue, if queued
+static void SWT_Remove(void)
+{
+	SWT_Mask();
+	if (!(swt_running & swt_mask)) return;
+	swt_running = swt_running & ~swt_mask;
+
+	swt_target = swt_index;
+	swt_prev   = SWT_END;
+	swt_index  = swt_head;
+
+	while (swt_index != swt_target)
+	{
+		swt_prev  = swt_index;
+		SWT_Get_Next();
+		swt_index = swt_link;
+	}
+
+	// Hand the remaining ticks to the entry behind
+	SWT_Get_Next();
+	if (swt_link != SWT_END)
+	{
+		SWT_Get_Delta();
+		swt_remain = swt_value;
+		swt_index  = swt_link;
+		SWT_Get_Delta();
+		swt_value += swt_remain;
+		SWT_Set_Delta();
+	}
+
+	if (swt_prev == SWT_END) swt_head = swt_link;
+	else
+	{
+		swt_index = swt_prev;
+		SWT_Set_Next();
+	}
+}
+
+
+//===================//
+// PROGRAM FUNCTIONS //
+//===================//
+
+
+// INITIALIZE
+void SWT_Initialize(void)
+{
+	if (!swt_module_initialized)
+	{
+		$ SWT_TIMER_CTL STOP;
+		SWT_TIMER_CNT = 0;
+		SWT_TIMER_BND = SWT_BOUND;
+		SWT_TIMER_SCL = SWT_TIMER_DIV;
+
+		swt_head    = SWT_END;
+		swt_running = 0;
+		swt_expired = 0;
+
+		INTRQ.SWT_TIMER = 0;					// Ensure that timer interrupt is cleared
+		INTEN.SWT_TIMER = 1;					// Enable timer interrupt
+		$ SWT_TIMER_CTL SWT_TIMER_CLK;
+		swt_module_initialized = 1;
+	}
+}
+
+
+// START
+// Queue swt_id to expire after swt_ticks, then every swt_period if not 0
+void SWT_Start(void)
+{
+	if (swt_module_initialized && (swt_id < SWT_COUNT))
+	{
+		swt_inten = INTEN;
+		INTEN = 0;
+
+		swt_index = swt_id;
+		SWT_Remove();
+
+		swt_index = swt_id;
+		swt_value = swt_period;
+		SWT_Set_Reload();
+
+		swt_value = swt_ticks;
+		if (!swt_value) swt_value = 1;
+		SWT_Insert();
+
+		swt_expired = swt_expired & ~swt_mask;	// Drop a stale expiry
+
+		INTEN = swt_inten;
+	}
+}
+
+
+// STOP
+void SWT_Stop(void)
+{
+	if (swt_module_initialized && (swt_id < SWT_COUNT))
+	{
+		swt_inten = INTEN;
+		INTEN = 0;
+		swt_index = swt_id;
+		SWT_Remove();
+		INTEN = swt_inten;
+	}
+}
+
+
+// INTERRUPT
+void SWT_Tick_Interrupt(void)
+{
+	if (swt_module_initialized)
+	{
+		if (swt_head != SWT_END)
+		{
+			// Only the head counts down
+			swt_index = swt_head;
+			SWT_Get_Delta();
+			if (swt_value)
+			{
+				swt_value--;
+				SWT_Set_Delta();
+			}
+
+			// Pop every timer that is due on this tick
+			while (swt_head != SWT_END)
+			{
+				swt_index = swt_head;
+				SWT_Get_Delta();
+				if (swt_value) break;
+
+				SWT_Get_Next();
+				swt_head = swt_link;
+
+				SWT_Mask();
+				swt_running = swt_running & ~swt_mask;
+				swt_expired = swt_expired | swt_mask;
+
+				SWT_Get_Reload();
+				if (swt_value) SWT_Insert();
+			}
+		}
+
+		INTRQ.SWT_TIMER = 0;					// Clear timer interrupt flag
+	}
+}
+
+
+// RELEASE
+void SWT_Release(void)
+{
+	if (swt_module_initialized)
+	{
+		$ SWT_TIMER_CTL STOP;
+		INTEN.SWT_TIMER = 0;
+		swt_head    = SWT_END;
+		swt_running = 0;
+		swt_module_initialized = 0;
+	}
+}
+
+#ENDIF // PERIPH_SWTIMER
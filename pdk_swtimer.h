@@ -0,0 +1,60 @@
+/* pdk_swtimer.h
+
+Software timer wheel. SWT_COUNT virtual one-shot or periodic timers run
+from one hardware timer interrupt. Define PERIPH_SWTIMER in system_settings.h
+
+ROM Consumed : 338B / 0x152
+RAM Consumed :  23B / 0x17  +  5B per virtual timer
+
+
+NOTE:
+
+	Timers are kept in a delta queue sorted by expiry. Each entry holds the
+	ticks remaining after the entry in front of it, so a tick only touches
+	the head entry. Timers that expire on the same tick are popped together
+	and periodic timers are queued again with their reload value.
+
+	Expiry sets the timer's bit in swt_expired. The compiler cannot call
+	through function pointers, so the user program checks the bit in the
+	main loop, clears it and runs its handler there:
+
+		if (swt_expired.MY_TIMER) { swt_expired.MY_TIMER = 0; ... }
+
+	Place SWT_Tick_Interrupt under the SWT_INTR flag in the Interrupt
+	function. SWT_Start and SWT_Stop briefly clear INTEN and restore it on
+	return. The global interrupt enable is left as the caller had it.
+
+	Ticks are counted from the next tick interrupt, so a timer can fire up
+	to 1 tick early. Add 1 tick when a minimum delay matters.
+
+	SWT_Start on a running timer restarts it with the new ticks/period.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+//===========//
+// VARIABLES //
+//===========//
+
+EXTERN BYTE swt_id;       // Virtual timer [0 : SWT_COUNT - 1]
+EXTERN WORD swt_ticks;    // Ticks to first expiry, 0 is treated as 1
+EXTERN WORD swt_period;   // Ticks between later expiries, 0: One-shot
+EXTERN BYTE swt_expired;  // Bit per timer, set on expiry, cleared by user
+EXTERN BYTE swt_running;  // Bit per timer, set while queued
+
+
+//===================//
+// PROGRAM FUNCTIONS //
+//===================//
+
+void	SWT_Initialize       (void);
+void	SWT_Start            (void);
+void	SWT_Stop             (void);
+void	SWT_Tick_Interrupt   (void);
+void	SWT_Release          (void);
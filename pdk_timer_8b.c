@@ -6,16 +6,49 @@
 ROM Consumed : 132B / 0x84  -  WITHOUT SOLVER & TM2/TM3
 RAM Consumed : 12B  / 0x0C  -  WITHOUT SOLVER & TM2/TM3
 
-ROM Consumed : 595B / 0x253 -  WITH SOLVER & TM2/TM3
-RAM Consumed :  35B / 0x23  -  WITH SOLVER & TM2/TM3
+ROM Consumed : ~700B       -  WITH SOLVER & TM2/TM3
+RAM Consumed :  42B / 0x2A  -  WITH SOLVER & TM2/TM3
 
 
 NOTE:
 	Approximately 1/2 of the solver memory is due to the math library.
 
-	Period solver takes ~2.5ms to complete. Nearly all solutions <10ms.
+	Period solver takes <200us for ratios above 2048 and ~450us worst case,
+	when the ratio is just above 256. The result is the closest scalar and
+	bound pair, and the leftover is reported in timer8_error.
 	PWM solver takes ~500us to complete.
 
+	SOLVER REPORT: With TIMER8_SOLVER_REPORT set, every run time solve
+	writes the achieved frequency to timer8_actual_freq and the error
+	against the target to timer8_error_ppm. Adds ~700us per solve.
+	Out of range targets are not rejected, check timer8_error_ppm.
+
+	SPEED / ACCURACY: timer8_solve_ppm = 0 walks every scalar for the
+	closest result. Any other value stops the period solver at the first
+	scalar within that many ppm, which bounds solve time on the hot path.
+	Set it to 0 at boot for exact settings. Default is TIMER8_SOLVE_PPM.
+
+	ILRC: With PERIPH_ILRC, run time solves for ILRC clocked timers use
+	ilrc_hz from ILRC_Calibrate instead of TIMER8_x_HZ. Build time
+	targets and presets are still solved against TIMER8_x_HZ.
+
+	LIVE UPDATE: Start clears the counter, so calling Stop/Set/Start on a
+	running timer cuts the current period short. With TIMER8_LIVE_UPDATE
+	enabled and timer8_live_update set, Set_Parameters and Apply_Preset
+	only stage the new bound and scalar. TimerX_Commit, called from the
+	timer interrupt, loads them right after the counter rolls over.
+
+	When TIMER8_2_TARGET / TIMER8_3_TARGET is set in system_settings.h, that
+	timer is solved at build time and Set_Parameters only writes registers.
+	timer8_use_solver and the solver variables are ignored for that timer.
+	With every used timer solved at build time, TIMER8_SOLVER_ENABLE can be
+	set to 0 to drop the solver and the math library.
+
+	Timer2 and Timer3 share one source, pdk_timer_8b.inc, included once
+	per timer enabled with TIMER8_USE_TMx. ROM grows per enabled timer.
+	The register writes stay per timer because IO registers cannot be
+	addressed through a pointer.
+
 	
 DOCUMENTATION ERROR:
 
@@ -39,6 +72,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 
 #IFIDNI PERIPH_TIMER8, 1
 #include "pdk_math.h"
+#IF PERIPH_ILRC
+#include "pdk_ilrc.h"
+#ENDIF
 
 
 //===========//
@@ -50,21 +86,59 @@ BYTE timer8_flags     = 0;
 BYTE timer8_prescalar = 0; // 6-bit  [1, 4, 16, 64]
 BYTE timer8_scalar    = 0; // 5-bit  [0 : 31]
 BYTE timer8_bound     = 0; // 8-bit bound register
+BYTE timer8_preset    = 0; // ROM preset index for TimerX_Apply_Preset
 
 BIT  timer8_tm2_init   : timer8_flags.?;
 BIT  timer8_tm3_init   : timer8_flags.?;
 BIT  timer8_use_solver : timer8_flags.?; // Flag to select solver, if available
 BIT  timer8_use_6b_pwm : timer8_flags.?;
 
+STATIC BYTE timer8_scl_reg = 0; // Prescaler and scalar bits for TMxS
+
+
+#IF TIMER8_LIVE_UPDATE
+
+	BIT  timer8_live_update  : timer8_flags.?; // Set_Parameters stages values for TimerX_Commit
+	BIT  timer8_tm2_pending  : timer8_flags.?;
+	BIT  timer8_tm3_pending  : timer8_flags.?;
+
+	#IF TIMER8_USE_TM2
+		STATIC BYTE timer8_tm2_next_bnd = 0;
+		STATIC BYTE timer8_tm2_next_scl = 0;
+	#ENDIF
+
+	#IF TIMER8_USE_TM3
+		STATIC BYTE timer8_tm3_next_bnd = 0;
+		STATIC BYTE timer8_tm3_next_scl = 0;
+	#ENDIF
+
+#ENDIF
+
 
 #IF TIMER8_SOLVER_ENABLE
 
 	STATIC EWORD  timer8_clock_ratio  = 0;
 	STATIC EWORD  timer8_pwm_clk      = 0;
-	STATIC BYTE  &timer8_tolerance    = timer8_scalar$0;
+	STATIC BYTE   timer8_step4        = 0;
+	BYTE          timer8_error        = 0;                     // |ratio - (scalar + 1) x (bound + 1)|
 	BYTE         &timer8_duty_percent = timer8_bound$0;       // Integer, [0 : 100]
 	EWORD        &timer8_target_freq  = timer8_clock_ratio$0; // Hz
 
+	WORD          timer8_solve_ppm    = TIMER8_SOLVE_PPM;      // 0: Best result, other: First result within ppm
+	STATIC BYTE   timer8_solve_tol    = 0;                     // timer8_solve_ppm in ratio counts
+
+	#IF TIMER8_SOLVER_REPORT
+		BIT   timer8_pwm_mode     : timer8_flags.?;
+		EWORD timer8_actual_freq  = 0;                         // Hz, result of the last solve
+		EWORD timer8_error_ppm    = 0;                         // |actual - target| / target x 10^6
+	#ENDIF
+
+	// Period solver working registers, valid once the clock ratio is known
+	STATIC WORD  &timer8_quotient     = timer8_clock_ratio$0;
+	STATIC BYTE  &timer8_step_min     = timer8_clock_ratio$2;
+	STATIC WORD  &timer8_remainder    = timer8_pwm_clk$0;
+	STATIC BYTE  &timer8_step         = timer8_pwm_clk$2;
+
 #ENDIF
 
 
@@ -72,6 +146,26 @@ BIT  timer8_use_6b_pwm : timer8_flags.?;
 // STATIC FUNCTIONS //
 //==================//
 
+// Prescaler and scalar into TMxS bit layout
+static void Timer8_Convert_Prescalar(void)
+{
+	switch (timer8_prescalar)
+	{
+		case 64 :   timer8_scl_reg = 0b01100000 | timer8_scalar;
+					break;
+
+		case 16 :   timer8_scl_reg = 0b01000000 | timer8_scalar;
+					break;
+
+		case  4 :   timer8_scl_reg = 0b00100000 | timer8_scalar;
+					break;
+
+		default :   timer8_scl_reg = timer8_scalar;
+
+	}
+}
+
+
 #IF TIMER8_SOLVER_ENABLE
 
 
@@ -88,8 +182,7 @@ static void Timer8_Solve_Duty(void)
 
 	// Convert bound to integer
 	math_dividend = math_product;
-	math_divisor = 100;
-	word_divide();
+	Eword_Divide_Const (100);
 
 	timer8_bound = (math_quotient$0 - 1);
 }
@@ -99,6 +192,10 @@ static void Timer8_Solve_PWM(void)
 {
 	if (!timer8_target_freq) timer8_target_freq = (timer8_pwm_clk >> 4); // Default : Clk / 16
 
+	#IF TIMER8_SOLVER_REPORT
+		timer8_actual_freq = timer8_target_freq; // Target, kept for Timer8_Report
+	#ENDIF
+
 
 	// PWM_CLK / BIT_DEPTH => PWM CYCLES per SECOND
 	math_dividend = timer8_pwm_clk;
@@ -140,6 +237,10 @@ static void Timer8_Solve_Period(void)
 
 	if (!timer8_target_freq) timer8_target_freq = (timer8_pwm_clk >> 4); // Default : Clk / 16
 
+	#IF TIMER8_SOLVER_REPORT
+		timer8_actual_freq = timer8_target_freq; // Target, kept for Timer8_Report
+	#ENDIF
+
 	// Solve for number of targets per unit of pwm clock
 	math_dividend = timer8_pwm_clk;
 	math_divisor  = timer8_target_freq;
@@ -167,203 +268,321 @@ static void Timer8_Solve_Period(void)
 	else if (timer8_prescalar == 6)	{timer8_prescalar = 64;} // 0b11
 
 
-	// Find the closest combination of scalar and count registers through brute force.
-	timer8_tolerance = -1;         // Adjust tolerance to solve for prime numbers
-	do                      // Tolerance loop
+	// Ratios that fit the bound register are exact with scalar = 0
+	if (timer8_clock_ratio <= 256)
 	{
-		timer8_bound = 255;
-		timer8_tolerance++;
-		do                  // Scalar loop
-		{
-			math_dividend = timer8_clock_ratio;
-			math_divisor = timer8_bound + 1;
-			word_divide();
-			timer8_bound--;
-
-		} while((math_remainder > timer8_tolerance) && (timer8_bound > 0));
-	} while ((math_remainder > timer8_tolerance) && (timer8_tolerance < 32));
-
-	timer8_bound++;
-	timer8_scalar = math_quotient$0 - 1;
-}
-
-#ENDIF //SOLVER_OPTION
-
-//===================//
-// PROGRAM FUNCTIONS //
-//===================//
-
+		if (!timer8_clock_ratio) timer8_clock_ratio = 1;
+		timer8_scalar = 0;
+		timer8_bound  = timer8_clock_ratio$0 - 1;
+		timer8_error  = 0;
+		return;
+	}
+	if (timer8_clock_ratio > 8192) timer8_clock_ratio = 8192;
 
 
-// TIMER 2 //
+	// Leftover counts allowed by timer8_solve_ppm, ratio x ppm / 2^20.
+	// 2^20 is used for 10^6, so the limit is ~5% tighter than asked.
+	timer8_solve_tol = 0;
+	if (timer8_solve_ppm)
+	{
+		math_mult_a = timer8_clock_ratio;
+		math_mult_b = timer8_solve_ppm;
+		word_multiply();
+		math_product >>= 4;
 
-#IF TIMER8_USE_TM2
+		if (math_product$3) timer8_solve_tol = 0xFF;
+		else                timer8_solve_tol = math_product$2;
+	}
 
-void Timer2_Stop(void)
-{
-	if (timer8_tm2_init) $ TIMER8_2_CTL STOP, TIMER8_2_OUT, TIMER8_2_MODE, TIMER8_2_POL;
-}
 
+	// Smallest (scalar + 1) that keeps (bound + 1) <= 256. Staged in timer8_step,
+	// timer8_step_min shares the ratio's top byte, which the quotient still reads.
+	timer8_step = timer8_clock_ratio$1;
+	if (timer8_clock_ratio$0) timer8_step++;
 
-void Timer2_Start(void)
-{
-	if (timer8_tm2_init) 
-	{
-		TIMER8_2_CNT = 0;
-		$ TIMER8_2_CTL TIMER8_2_CLK, TIMER8_2_OUT, TIMER8_2_MODE, TIMER8_2_POL;
-	}
-}
 
+	// Walk (scalar + 1) = step down from 32 while tracking ratio = quotient x step + remainder.
+	// Going from step to step - 1 adds quotient to the remainder, and the remainder is then
+	// brought back under step. No division is needed and the quotient only ever grows
+	// to 256, so the whole walk is bounded. See tools/timer8_walk_check.cpp.
+	timer8_remainder = timer8_clock_ratio$0 & 0x1F;
+	timer8_quotient  = timer8_clock_ratio >> 5;
+	timer8_step_min  = timer8_step;
+	timer8_step      = 32;
+	timer8_step4     = 128;
+	timer8_error     = 0xFF;
 
-void Timer2_Set_Parameters(void)
-{
-	if (timer8_tm2_init)
+	while (1)
 	{
-		#IF TIMER8_SOLVER_ENABLE
-			if (timer8_use_solver) 
+		// Closest bound for this scalar is quotient or quotient + 1
+		A = timer8_step - timer8_remainder$0;
+		if ((A < timer8_remainder$0) && (timer8_quotient < 256))
+		{
+			if (A < timer8_error)
 			{
-				timer8_pwm_clk =  TIMER8_2_HZ;
-				#IFIDNI TIMER8_2_MODE, PWM
-					#IF TIMER8_2_6BIT 
-						timer8_use_6b_pwm = 1;
-					#ELSE 
-						timer8_use_6b_pwm = 0;
-					#ENDIF
-					else timer8_use_6b_pwm = 0;
-					Timer8_Solve_PWM();
-					Timer8_Solve_Duty();
-				#ELSE
-					Timer8_Solve_Period();
-				#ENDIF	
+				timer8_error  = A;
+				timer8_scalar = timer8_step - 1;
+				timer8_bound  = timer8_quotient$0;
 			}
-		#ENDIF
-
-		TIMER8_2_BND = timer8_bound;
-
-		switch (timer8_prescalar)
+		}
+		else if (timer8_remainder$0 < timer8_error)
 		{
-			case 64 :   TIMER8_2_SCL = TIMER8_2_RES | 0b01100000 | timer8_scalar;
-						break;
+			timer8_error  = timer8_remainder$0;
+			timer8_scalar = timer8_step - 1;
+			timer8_bound  = timer8_quotient$0 - 1;
+		}
 
-			case 16 :   TIMER8_2_SCL = TIMER8_2_RES | 0b01000000 | timer8_scalar;
-						break;
+		if ((timer8_error <= timer8_solve_tol) || (timer8_step == timer8_step_min)) break;
 
-			case  4 :   TIMER8_2_SCL = TIMER8_2_RES | 0b00100000 | timer8_scalar;
-						break;
+		timer8_step--;
+		timer8_step4 -= 4;
+		timer8_remainder += timer8_quotient;
 
-			default :   TIMER8_2_SCL = TIMER8_2_RES | timer8_scalar;
+		while (timer8_remainder >= timer8_step4)
+		{
+			timer8_remainder -= timer8_step4;
+			timer8_quotient  += 4;
+		}
 
-		}	
+		while (timer8_remainder >= timer8_step)
+		{
+			timer8_remainder -= timer8_step;
+			timer8_quotient++;
+		}
 	}
 }
 
+#IF TIMER8_SOLVER_REPORT
 
-void Timer2_Initialize(void)
+// Achieved frequency and ppm error of the solved registers.
+// Expects timer8_pwm_clk = timer clock and timer8_actual_freq = target.
+static void Timer8_Report(void)
 {
-	if (!timer8_tm2_init)
-	{
-		timer8_tm2_init = 1;
-		Timer2_Stop();
-	}
-}
-
+	// Timer clocks per output period, P x (S + 1) x depth in PWM mode,
+	// P x (S + 1) x (B + 1) x 2 in period mode since the output toggles
+	math_mult_a = timer8_prescalar;
+	math_mult_b = timer8_scalar + 1;
+	word_multiply();
 
-void Timer2_Release(void)
-{
-	if (timer8_tm2_init) 
+	math_mult_a = math_product;
+	if (timer8_pwm_mode)
 	{
-		TIMER8_2_CTL = 0;
-		timer8_tm2_init = 0;
+		if (timer8_use_6b_pwm) math_mult_b = 64;
+		else math_mult_b = 256;
 	}
-}
+	else math_mult_b = timer8_bound + 1;
+	word_multiply();
+	if (!timer8_pwm_mode) math_product <<= 1;
 
-#ENDIF // TIMER8_USE_TM2
 
+	// Achieved Hz, rounded
+	math_divisor   = math_product;
+	math_dividend  = math_divisor;
+	math_dividend >>= 1;
+	math_dividend += timer8_pwm_clk;
+	dword_divide();
 
+	math_mult_db       = timer8_actual_freq;
+	timer8_actual_freq = math_quotient;
 
 
-// TIMER 3 //
-
+	// Error against target x clocks per period. math_mult_da still holds the clocks.
+	eword_multiply();
+	if (math_product_h) timer8_error_ppm = 0xFFFFFF;
+	else
+	{
+		math_mult_db = math_product;
+		math_mult_da = timer8_pwm_clk;
+		ppm_error();
+		timer8_error_ppm = math_quotient;
+	}
+}
 
-#IF TIMER8_USE_TM3
+#ENDIF
 
-void Timer3_Stop(void)
-{
-	if (timer8_tm3_init) $ TIMER8_3_CTL STOP, TIMER8_3_OUT, TIMER8_3_MODE, TIMER8_3_POL;
-}
 
+#ENDIF //SOLVER_OPTION
 
-void Timer3_Start(void)
-{
-	if (timer8_tm3_init) 
-	{
-		TIMER8_3_CNT = 0;
-		$ TIMER8_3_CTL TIMER8_3_CLK, TIMER8_3_OUT, TIMER8_3_MODE, TIMER8_3_POL;
-	}
-}
+//===================//
+// PROGRAM FUNCTIONS //
+//===================//
 
 
-void Timer3_Set_Parameters(void)
-{
-	if (timer8_tm3_init)
-	{
-		#IF TIMER8_SOLVER_ENABLE
-			if (timer8_use_solver) 
-			{
-				timer8_pwm_clk =  TIMER8_3_HZ;
-				#IFIDNI TIMER8_3_MODE, PWM
-					#IF TIMER8_3_6BIT 
-						timer8_use_6b_pwm = 1;
-					#ELSE 
-						timer8_use_6b_pwm = 0;
-					#ENDIF
-					Timer8_Solve_PWM();
-					Timer8_Solve_Duty();
-				#ELSE
-					Timer8_Solve_Period();
-				#ENDIF	
-			}
-		#ENDIF
 
-		TIMER8_3_BND = timer8_bound;
+// TIMER 2 //
 
-		switch (timer8_prescalar)
-		{
-			case 64 :   TIMER8_3_SCL = TIMER8_3_RES | 0b01100000 | timer8_scalar;
-						break;
+#IF TIMER8_USE_TM2
 
-			case 16 :   TIMER8_3_SCL = TIMER8_3_RES | 0b0100000 | timer8_scalar;
-						break;
+	#define TM8_CTL             TIMER8_2_CTL
+	#define TM8_CNT             TIMER8_2_CNT
+	#define TM8_SCL             TIMER8_2_SCL
+	#define TM8_BND             TIMER8_2_BND
+	#define TM8_CLK             TIMER8_2_CLK
+	#define TM8_OUT             TIMER8_2_OUT
+	#define TM8_MODE            TIMER8_2_MODE
+	#define TM8_POL             TIMER8_2_POL
+	#define TM8_RES             TIMER8_2_RES
+	#define TM8_6BIT            TIMER8_2_6BIT
+	#define TM8_TARGET          TIMER8_2_TARGET
+	#define TM8_BUILD_BND       TIMER8_2_BUILD_BND
+	#define TM8_BUILD_PRE       TIMER8_2_BUILD_PRE
+	#define TM8_BUILD_SCL       TIMER8_2_BUILD_SCL
+	#define TM8_PRESETS         TIMER8_2_PRESETS
+
+	#define TM8_HZ              TIMER8_2_HZ
+	#ifidni TIMER8_2_CLK, ILRC
+		#if PERIPH_ILRC
+			#undef  TM8_HZ
+			#define TM8_HZ      ilrc_hz		// Measured by ILRC_Calibrate
+		#endif
+	#endif
+
+	#ifidni TIMER8_2_MODE, PWM
+		#define TM8_IS_PWM      1
+	#else
+		#define TM8_IS_PWM      0
+	#endif
+
+	#define TM8_INIT            timer8_tm2_init
+	#define TM8_PENDING         timer8_tm2_pending
+	#define TM8_NEXT_BND        timer8_tm2_next_bnd
+	#define TM8_NEXT_SCL        timer8_tm2_next_scl
+
+	#define TM8_STOP            Timer2_Stop
+	#define TM8_START           Timer2_Start
+	#define TM8_LOAD            Timer2_Load
+	#define TM8_SET_PARAMETERS  Timer2_Set_Parameters
+	#define TM8_INITIALIZE      Timer2_Initialize
+	#define TM8_RELEASE         Timer2_Release
+	#define TM8_APPLY_PRESET    Timer2_Apply_Preset
+	#define TM8_COMMIT          Timer2_Commit
+	#define TM8_PRESET_SCL      Timer2_Preset_Scl
+	#define TM8_PRESET_BND      Timer2_Preset_Bnd
+
+	#include "pdk_timer_8b.inc"
+
+	#undef  TM8_CTL
+	#undef  TM8_CNT
+	#undef  TM8_SCL
+	#undef  TM8_BND
+	#undef  TM8_CLK
+	#undef  TM8_OUT
+	#undef  TM8_MODE
+	#undef  TM8_POL
+	#undef  TM8_HZ
+	#undef  TM8_RES
+	#undef  TM8_6BIT
+	#undef  TM8_TARGET
+	#undef  TM8_BUILD_BND
+	#undef  TM8_BUILD_PRE
+	#undef  TM8_BUILD_SCL
+	#undef  TM8_PRESETS
+	#undef  TM8_IS_PWM
+	#undef  TM8_INIT
+	#undef  TM8_PENDING
+	#undef  TM8_NEXT_BND
+	#undef  TM8_NEXT_SCL
+	#undef  TM8_STOP
+	#undef  TM8_START
+	#undef  TM8_LOAD
+	#undef  TM8_SET_PARAMETERS
+	#undef  TM8_INITIALIZE
+	#undef  TM8_RELEASE
+	#undef  TM8_APPLY_PRESET
+	#undef  TM8_COMMIT
+	#undef  TM8_PRESET_SCL
+	#undef  TM8_PRESET_BND
 
-			case  4 :   TIMER8_3_SCL = TIMER8_3_RES | 0b0100000 | timer8_scalar;
-						break;
+#ENDIF // TIMER8_USE_TM2
 
-			default :   TIMER8_3_SCL = TIMER8_3_RES | timer8_scalar;
 
-		}	
-	}
-}
 
 
-void Timer3_Initialize(void)
-{
-	if (!timer8_tm3_init)
-	{
-		timer8_tm3_init = 1;
-		Timer2_Stop();
-	}
-}
+// TIMER 3 //
 
+#IF TIMER8_USE_TM3
 
-void Timer3_Release(void)
-{
-	if (timer8_tm3_init) 
-	{
-		TIMER8_3_CTL = 0;
-		timer8_tm3_init = 0;
-	}
-}
+	#define TM8_CTL             TIMER8_3_CTL
+	#define TM8_CNT             TIMER8_3_CNT
+	#define TM8_SCL             TIMER8_3_SCL
+	#define TM8_BND             TIMER8_3_BND
+	#define TM8_CLK             TIMER8_3_CLK
+	#define TM8_OUT             TIMER8_3_OUT
+	#define TM8_MODE            TIMER8_3_MODE
+	#define TM8_POL             TIMER8_3_POL
+	#define TM8_RES             TIMER8_3_RES
+	#define TM8_6BIT            TIMER8_3_6BIT
+	#define TM8_TARGET          TIMER8_3_TARGET
+	#define TM8_BUILD_BND       TIMER8_3_BUILD_BND
+	#define TM8_BUILD_PRE       TIMER8_3_BUILD_PRE
+	#define TM8_BUILD_SCL       TIMER8_3_BUILD_SCL
+	#define TM8_PRESETS         TIMER8_3_PRESETS
+
+	#define TM8_HZ              TIMER8_3_HZ
+	#ifidni TIMER8_3_CLK, ILRC
+		#if PERIPH_ILRC
+			#undef  TM8_HZ
+			#define TM8_HZ      ilrc_hz		// Measured by ILRC_Calibrate
+		#endif
+	#endif
+
+	#ifidni TIMER8_3_MODE, PWM
+		#define TM8_IS_PWM      1
+	#else
+		#define TM8_IS_PWM      0
+	#endif
+
+	#define TM8_INIT            timer8_tm3_init
+	#define TM8_PENDING         timer8_tm3_pending
+	#define TM8_NEXT_BND        timer8_tm3_next_bnd
+	#define TM8_NEXT_SCL        timer8_tm3_next_scl
+
+	#define TM8_STOP            Timer3_Stop
+	#define TM8_START           Timer3_Start
+	#define TM8_LOAD            Timer3_Load
+	#define TM8_SET_PARAMETERS  Timer3_Set_Parameters
+	#define TM8_INITIALIZE      Timer3_Initialize
+	#define TM8_RELEASE         Timer3_Release
+	#define TM8_APPLY_PRESET    Timer3_Apply_Preset
+	#define TM8_COMMIT          Timer3_Commit
+	#define TM8_PRESET_SCL      Timer3_Preset_Scl
+	#define TM8_PRESET_BND      Timer3_Preset_Bnd
+
+	#include "pdk_timer_8b.inc"
+
+	#undef  TM8_CTL
+	#undef  TM8_CNT
+	#undef  TM8_SCL
+	#undef  TM8_BND
+	#undef  TM8_CLK
+	#undef  TM8_OUT
+	#undef  TM8_MODE
+	#undef  TM8_POL
+	#undef  TM8_HZ
+	#undef  TM8_RES
+	#undef  TM8_6BIT
+	#undef  TM8_TARGET
+	#undef  TM8_BUILD_BND
+	#undef  TM8_BUILD_PRE
+	#undef  TM8_BUILD_SCL
+	#undef  TM8_PRESETS
+	#undef  TM8_IS_PWM
+	#undef  TM8_INIT
+	#undef  TM8_PENDING
+	#undef  TM8_NEXT_BND
+	#undef  TM8_NEXT_SCL
+	#undef  TM8_STOP
+	#undef  TM8_START
+	#undef  TM8_LOAD
+	#undef  TM8_SET_PARAMETERS
+	#undef  TM8_INITIALIZE
+	#undef  TM8_RELEASE
+	#undef  TM8_APPLY_PRESET
+	#undef  TM8_COMMIT
+	#undef  TM8_PRESET_SCL
+	#undef  TM8_PRESET_BND
 
 #ENDIF // TIMER8_USE_TM3
 
+
 #ENDIF // PERIPH_TIMER8
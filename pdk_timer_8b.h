@@ -6,16 +6,49 @@
 ROM Consumed : 132B / 0x84  -  WITHOUT SOLVER & TM2/TM3
 RAM Consumed : 12B  / 0x0C  -  WITHOUT SOLVER & TM2/TM3
 
-ROM Consumed : 595B / 0x253 -  WITH SOLVER & TM2/TM3
-RAM Consumed :  35B / 0x23  -  WITH SOLVER & TM2/TM3
+ROM Consumed : ~700B       -  WITH SOLVER & TM2/TM3
+RAM Consumed :  42B / 0x2A  -  WITH SOLVER & TM2/TM3
 
 
 NOTE:
 	Approximately 1/2 of the solver memory is due to the math library.
 
-	Period solver takes ~2.5ms to complete. Nearly all solutions <10ms.
+	Period solver takes <200us for ratios above 2048 and ~450us worst case,
+	when the ratio is just above 256. The result is the closest scalar and
+	bound pair, and the leftover is reported in timer8_error.
 	PWM solver takes ~500us to complete.
 
+	SOLVER REPORT: With TIMER8_SOLVER_REPORT set, every run time solve
+	writes the achieved frequency to timer8_actual_freq and the error
+	against the target to timer8_error_ppm. Adds ~700us per solve.
+	Out of range targets are not rejected, check timer8_error_ppm.
+
+	SPEED / ACCURACY: timer8_solve_ppm = 0 walks every scalar for the
+	closest result. Any other value stops the period solver at the first
+	scalar within that many ppm, which bounds solve time on the hot path.
+	Set it to 0 at boot for exact settings. Default is TIMER8_SOLVE_PPM.
+
+	ILRC: With PERIPH_ILRC, run time solves for ILRC clocked timers use
+	ilrc_hz from ILRC_Calibrate instead of TIMER8_x_HZ. Build time
+	targets and presets are still solved against TIMER8_x_HZ.
+
+	LIVE UPDATE: Start clears the counter, so calling Stop/Set/Start on a
+	running timer cuts the current period short. With TIMER8_LIVE_UPDATE
+	enabled and timer8_live_update set, Set_Parameters and Apply_Preset
+	only stage the new bound and scalar. TimerX_Commit, called from the
+	timer interrupt, loads them right after the counter rolls over.
+
+	When TIMER8_2_TARGET / TIMER8_3_TARGET is set in system_settings.h, that
+	timer is solved at build time and Set_Parameters only writes registers.
+	timer8_use_solver and the solver variables are ignored for that timer.
+	With every used timer solved at build time, TIMER8_SOLVER_ENABLE can be
+	set to 0 to drop the solver and the math library.
+
+	Timer2 and Timer3 share one source, pdk_timer_8b.inc, included once
+	per timer enabled with TIMER8_USE_TMx. ROM grows per enabled timer.
+	The register writes stay per timer because IO registers cannot be
+	addressed through a pointer.
+
 	
 DOCUMENTATION ERROR:
 
@@ -39,15 +72,27 @@ Copyright (c) 2021 Robert R. Puccinelli
 // VARIABLES //
 //===========//
 
-EXTERN BYTE	timer8_prescaler;  // 6-bit  [1, 4, 16, 64]
-EXTERN WORD	timer8_scalar;     // 5-bit  [0 : 31]
-EXTERN WORD	timer8_bound;      // 8-bit bound register
+EXTERN BYTE	timer8_prescalar;  // 6-bit  [1, 4, 16, 64]
+EXTERN BYTE	timer8_scalar;     // 5-bit  [0 : 31]
+EXTERN BYTE	timer8_bound;      // 8-bit bound register
+EXTERN BYTE	timer8_preset;     // ROM preset index, see tools/preset_gen.cpp
 
 
 // SOLVER VARIABLES - ONLY AVAILABLE WHEN TIMER8_SOLVER_ENABLE IS SET TO 1
 EXTERN BIT    timer8_use_solver;   // Flag to select parameter solver
 EXTERN BYTE  &timer8_duty_percent; // Duty [0 : 100]
 EXTERN EWORD &timer8_target_freq;  // Target PWM Hz
+EXTERN BYTE   timer8_error;        // Period solver leftover timer counts
+EXTERN WORD   timer8_solve_ppm;    // 0: Best result, other: Stop at first result within ppm
+
+
+// REPORT VARIABLES - ONLY AVAILABLE WHEN TIMER8_SOLVER_REPORT IS SET TO 1
+EXTERN EWORD  timer8_actual_freq;  // Hz achieved by the last solve
+EXTERN EWORD  timer8_error_ppm;    // |actual - target| / target x 10^6, 0xFFFFFF max
+
+
+// LIVE UPDATE VARIABLES - ONLY AVAILABLE WHEN TIMER8_LIVE_UPDATE IS SET TO 1
+EXTERN BIT    timer8_live_update;  // Stage parameters for TimerX_Commit
 
 
 //===================//
@@ -59,9 +104,13 @@ void	Timer2_Set_Parameters (void);
 void	Timer2_Start          (void);
 void	Timer2_Stop           (void);
 void	Timer2_Release        (void);
+void	Timer2_Apply_Preset   (void); // TIMER8_2_PRESETS > 0 only
+void	Timer2_Commit         (void); // TIMER8_LIVE_UPDATE only, call from interrupt
 
 void	Timer3_Initialize     (void);
 void	Timer3_Set_Parameters (void);
 void	Timer3_Start          (void);
 void	Timer3_Stop           (void);
-void	Timer3_Release        (void);
\ No newline at end of file
+void	Timer3_Release        (void);
+void	Timer3_Apply_Preset   (void); // TIMER8_3_PRESETS > 0 only
+void	Timer3_Commit         (void); // TIMER8_LIVE_UPDATE only, call from interrupt
\ No newline at end of file
@@ -32,6 +32,7 @@ Copyright (c) 2021 Robert R. Puccinelli
 #define ICE_ILRC_HZ    34700     // ILRC clock of ICE for code validation
 
 #define PERIPH_MATH    0         // Math utility.  Disable: 0, Enable: 1
+#define PERIPH_FIXED   0         // Fixed point.   Disable: 0, Enable: 1
 #define PERIPH_I2C     0         // I2C Master.    Disable: 0, Enable: 1
 #define PERIPH_PWM_11B 0         // 11B PWM.       Disable: 0, Enable: 1
 #define PERIPH_BUTTON  0         // Buttons.       Disable: 0, Enable: 1
@@ -39,6 +40,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 #define PERIPH_EEPROM  0         // EEPROM.        Disable: 0, Enable: 1
 #define PERIPH_STEPPER 0         // Stepper motor. Disable: 0, Enable: 1
 #define PERIPH_TIMER8  0 
+#define PERIPH_SWTIMER 0         // Soft timers.   Disable: 0, Enable: 1
+#define PERIPH_ILRC    0         // ILRC calib.    Disable: 0, Enable: 1
+#define PERIPH_POSTSCL 0         // Slow output.   Disable: 0, Enable: 1
 
 //======================//
 // RESOURCE UTILIZATION //
@@ -55,9 +59,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 //    PA6    I2C_SDA       PB6    TM3         PC6    X
 //    PA7    I2C_SCL       PB7    BTN         PC7    X
 //
-//    TM16   -
-//    TM2    BTN
-//    TM3    -
+//    TM16   ILRC_CAL
+//    TM2    BTN, I2C_ASYNC (one of them, BTN_USE_SWT leaves TM2 free)
+//    TM3    SWT
 //
 //    PWMG0  STEP_S
 //    PWMG1  -
@@ -129,6 +133,82 @@ Copyright (c) 2021 Robert R. Puccinelli
 //=====================//
 
 
+//==============//
+// MATH UTILITY //
+//==============//
+#ifidni PERIPH_MATH, 1
+	#define MATH_ISR_SAVE  0  // Shadow math registers for use in interrupts. 0/1
+	                          // CHECK HEADER FOR RESOURCE USAGE!
+
+	#define MATH_FIR_ENABLE 0                 // FIR filter helper. 0/1
+	#define MATH_FIR_TAPS   8                 // Number of taps [1 : 255]
+	#define MATH_FIR_TABLE  Fir_Coefficients  // ROM table in user program:
+	                                          //   pcadd A; ret c0; ret c1; ...
+#endif
+
+
+//=============//
+// FIXED POINT //
+//=============//
+#ifidni PERIPH_FIXED, 1
+	#ifz PERIPH_MATH
+		.error PERIPH_FIXED requires PERIPH_MATH to be enabled!
+	#endif
+#endif
+
+
+//==================//
+// ILRC CALIBRATION //
+//==================//
+#ifidni PERIPH_ILRC, 1
+    #define ILRC_CAL_SHIFT 5       // Window = 1 / 2^shift s. 5: 31.25 ms, 32 Hz steps
+                                   // ILRC_HZ / 2^shift MUST BE < 65536
+#endif
+
+
+//================//
+// SOFTWARE TIMER //
+//================//
+#ifidni PERIPH_SWTIMER, 1
+    #define SWT_COUNT      4       // Virtual timers [1 : 8]. Each uses 5B RAM
+    #define SWT_TICK_MS    1       // ms per tick
+
+    // Tick timer selection
+    #define SWT_TIMER      TM3
+    #define SWT_TIMER_CTL  TM3C
+    #define SWT_TIMER_CNT  TM3CT
+    #define SWT_TIMER_BND  TM3B
+    #define SWT_TIMER_SCL  TM3S
+    #define SWT_TIMER_CLK  ILRC    // Refer to datasheet and XXX.INC for options
+	#define SWT_INTR       INTR_TM3
+    #define SWT_TIMER_FREQ ILRC_HZ // ILRC_HZ is defined in IC definition above
+    #define SWT_TIMER_DIV  0       // [0 : 31] Clock divider
+    //  # of timer cycles = timer Hz / (clock divider + 1) x (tick ms / 1000)
+    //  # of timer cycles MUST BE [1:255]
+
+    // Virtual timers used by library modules, [0 : SWT_COUNT - 1]
+    #define SWT_ID_BTN     0       // Button debounce, BTN_USE_SWT
+    #define SWT_ID_LCD     1       // LCD waits, LCD_USE_SWT
+
+    ///////////////////////////
+    // DO NOT TOUCH -- START //
+    ///////////////////////////
+
+    #if (SWT_COUNT < 1) || (SWT_COUNT > 8)
+        .error SWT_COUNT must be [1 : 8]!
+    #endif
+
+    #define SWT_TICK_BND   (SWT_TIMER_FREQ / (SWT_TIMER_DIV + 1) / (1000 / SWT_TICK_MS))
+    #if (SWT_TICK_BND < 1) || (SWT_TICK_BND > 255)
+        .error SWT_TICK_MS cannot be reached with SWT_TIMER_DIV!
+    #endif
+
+    /////////////////////////
+    // DO NOT TOUCH -- END //
+    /////////////////////////
+#endif
+
+
 //============//
 // I2C MASTER //
 //============//
@@ -138,13 +218,33 @@ Copyright (c) 2021 Robert R. Puccinelli
     #define I2C_WR_CMD  0b0
     #define I2C_RD_CMD  0b1
 
-    //      T_xxx    nS
+    // Bus speed. STANDARD: 100kHz, FAST: 400kHz, FAST_PLUS: 1MHz, as minimum bus times
+    // CUSTOM: T_xxx below, no bus speed check
+    #define I2C_SPEED  STANDARD
+
+    //      T_xxx    nS     CUSTOM only. Minimum times
     #define T_High   4700
     #define T_Low    4700
     #define T_Start  4700
     #define T_Stop   4700
     #define T_Buf    4700
 
+    // Asynchronous engine, see pdk_i2c.c
+    #define I2C_ASYNC      0        // 1: Queue transactions for a timer interrupt
+    #define I2C_QUEUE      2        // Queued transactions [1 : 8]. Each uses 5B RAM
+    #define I2C_ASYNC_HZ   10000    // Half-bit ticks per second. SCL = I2C_ASYNC_HZ / 2
+    #define I2C_TIMER      TM2      // Not shared with BTN_TIMER, see RESOURCE UTILIZATION
+    #define I2C_TIMER_CTL  TM2C
+    #define I2C_TIMER_CNT  TM2CT
+    #define I2C_TIMER_BND  TM2B
+    #define I2C_TIMER_SCL  TM2S
+    #define I2C_TIMER_CLK  SYSCLK   // Refer to datasheet and XXX.INC for options
+    #define I2C_INTR       INTR_TM2
+    #define I2C_TIMER_FREQ SYSTEM_CLOCK
+    #define I2C_TIMER_DIV  3        // [0 : 31] Clock divider
+    //  # of timer cycles = timer Hz / (clock divider + 1) / I2C_ASYNC_HZ
+    //  # of timer cycles MUST BE [1:255]
+
     // Addresses
     #define    ST7032  62 // 0b0111110  // LCD Controller
     #define    M24C01  80 // 0b1010000  // EEPROM, STM device 0 (can have 8 on bus) 
@@ -154,12 +254,68 @@ Copyright (c) 2021 Robert R. Puccinelli
     // DO NOT TOUCH -- START //
     ///////////////////////////
 
-    // TIME TO CLOCK CONVERSION
-    #define I2C_D_HIGH   T_High    ?  (((SYSTEM_CLOCK) / (1000000000 / T_High))  + 1) : 0
-    #define I2C_D_LOW    T_Low     ?  (((SYSTEM_CLOCK) / (1000000000 / T_Low))   + 1) : 0
-    #define I2C_D_START  T_Start   ?  (((SYSTEM_CLOCK) / (1000000000 / T_Start)) + 1) : 0
-    #define I2C_D_STOP   T_Stop    ?  (((SYSTEM_CLOCK) / (1000000000 / T_Stop))  + 1) : 0
-    #define I2C_D_BUF    T_Buf     ?  (((SYSTEM_CLOCK) / (1000000000 / T_Buf))   + 1) : 0
+    // SPEED PROFILES
+    // Spec minimums, with T_High + T_Low stretched to the full SCL period
+    #ifidni I2C_SPEED, STANDARD
+        #undef  T_High
+        #undef  T_Low
+        #undef  T_Start
+        #undef  T_Stop
+        #undef  T_Buf
+        #define T_High   4700  // Spec 4000
+        #define T_Low    5300  // Spec 4700
+        #define T_Start  4700
+        #define T_Stop   4000
+        #define T_Buf    4700
+        #define I2C_HZ   100000
+    #elseifidni I2C_SPEED, FAST
+        #undef  T_High
+        #undef  T_Low
+        #undef  T_Start
+        #undef  T_Stop
+        #undef  T_Buf
+        #define T_High   1000  // Spec 600
+        #define T_Low    1500  // Spec 1300
+        #define T_Start  600
+        #define T_Stop   600
+        #define T_Buf    1300
+        #define I2C_HZ   400000
+    #elseifidni I2C_SPEED, FAST_PLUS
+        #undef  T_High
+        #undef  T_Low
+        #undef  T_Start
+        #undef  T_Stop
+        #undef  T_Buf
+        #define T_High   400   // Spec 260
+        #define T_Low    600   // Spec 500
+        #define T_Start  260
+        #define T_Stop   260
+        #define T_Buf    500
+        #define I2C_HZ   1000000
+    #elseifidni I2C_SPEED, CUSTOM
+        #define I2C_HZ   0
+    #else
+        .error I2C_SPEED must be STANDARD, FAST, FAST_PLUS or CUSTOM!
+    #endif
+
+    // TIME TO INSTRUCTION CYCLE CONVERSION, rounded up
+    #define I2C_KIPS     (SYSTEM_CLOCK / INSTR_CYCLES / 1000)
+    #define I2C_D_HIGH   ((I2C_KIPS * T_High  + 999999) / 1000000)
+    #define I2C_D_LOW    ((I2C_KIPS * T_Low   + 999999) / 1000000)
+    #define I2C_D_START  ((I2C_KIPS * T_Start + 999999) / 1000000)
+    #define I2C_D_STOP   ((I2C_KIPS * T_Stop  + 999999) / 1000000)
+    #define I2C_D_BUF    ((I2C_KIPS * T_Buf   + 999999) / 1000000)
+
+    #if I2C_ASYNC
+        #if (I2C_QUEUE < 1) || (I2C_QUEUE > 8)
+            .error I2C_QUEUE must be [1 : 8]!
+        #endif
+
+        #define I2C_ASYNC_BND  (I2C_TIMER_FREQ / (I2C_TIMER_DIV + 1) / I2C_ASYNC_HZ)
+        #if (I2C_ASYNC_BND < 1) || (I2C_ASYNC_BND > 255)
+            .error I2C_ASYNC_HZ cannot be reached with I2C_TIMER_DIV!
+        #endif
+    #endif
 
 
 
@@ -175,6 +331,7 @@ Copyright (c) 2021 Robert R. Puccinelli
 //==============//
 #ifidni PERIPH_BUTTON, 1
     #define BTN_WAKE_SYS   1
+    #define BTN_USE_SWT    0    // 1: Debounce on software timer SWT_ID_BTN, BTN_TIMER is left free
 
     // Debouncer timer selection
     #define BTN_TIMER      TM2
@@ -258,6 +415,44 @@ Copyright (c) 2021 Robert R. Puccinelli
     // DO NOT TOUCH -- START //
     ///////////////////////////
 
+    #if BTN_USE_SWT
+        #ifz PERIPH_SWTIMER
+            .error BTN_USE_SWT requires PERIPH_SWTIMER to be enabled!
+        #endif
+        #define BTN_SWT_TICKS  (BTN_DEBOUNCE_T / SWT_TICK_MS + 1)
+    #endif
+
+    // Debounce bound from ilrc_hz, see Button_Update_Timing
+    #define BTN_ILRC_CAL   0
+    #ifz BTN_USE_SWT
+        #ifidni BTN_TIMER_CLK, ILRC
+            #if PERIPH_ILRC
+                #ifz PERIPH_MATH
+                    .error PERIPH_ILRC with an ILRC debounce timer requires PERIPH_MATH to be enabled!
+                #endif
+                #undef  BTN_ILRC_CAL
+                #define BTN_ILRC_CAL   1
+            #endif
+        #endif
+    #endif
+
+    // The debounce timer and the I2C asynchronous engine cannot share a timer
+    #ifz BTN_USE_SWT
+        #ifidni PERIPH_I2C, 1
+            #if I2C_ASYNC
+                #ifidni     I2C_TIMER, TM2
+                    #ifidni BTN_TIMER, TM2
+                        .error I2C_ASYNC and BTN_TIMER both use TM2, set BTN_USE_SWT or move one!
+                    #endif
+                #elseifidni I2C_TIMER, TM3
+                    #ifidni BTN_TIMER, TM3
+                        .error I2C_ASYNC and BTN_TIMER both use TM3, set BTN_USE_SWT or move one!
+                    #endif
+                #endif
+            #endif
+        #endif
+    #endif
+
     #if BTN_USE_PA
         #define BTN_PA   ((BTN_PA7 << 7) | \
                          (BTN_PA6 << 6) | \
@@ -331,6 +526,7 @@ Copyright (c) 2021 Robert R. Puccinelli
     #define LCD_COMM_MODE  I2C       // Parallel not yet developed
     #define LCD_DRIVER     ST7032    // Only ST7032 is validated
     #define LCD_VOLTAGE    5         // Only 5V is validated
+    #define LCD_USE_SWT    0         // 1: Long waits on software timer SWT_ID_LCD instead of .delay
 
     // LCD Constants
     #define LCD_WIDTH      16        // Number of chars per line
@@ -481,6 +677,14 @@ Copyright (c) 2021 Robert R. Puccinelli
     #define LCD_PWR_D    LCD_PWR_T     ?  (SYSTEM_CLOCK / (1000000 / LCD_PWR_T)  / 2 + 1) : 0
     #define LCD_WAIT_D   LCD_WAIT_T    ?  (SYSTEM_CLOCK / (1000000 / LCD_WAIT_T) / 2 + 1) : 0
 
+    #if LCD_USE_SWT
+        #ifz PERIPH_SWTIMER
+            .error LCD_USE_SWT requires PERIPH_SWTIMER to be enabled!
+        #endif
+        #define LCD_INIT_TICKS  (LCD_INIT_T / 1000 / SWT_TICK_MS + 2)
+        #define LCD_PWR_TICKS   (LCD_PWR_T  / 1000 / SWT_TICK_MS + 2)
+    #endif
+
 
     // INTERFACE COMPATABILITY WARNING
     #ifidni LCD_COMM_MODE, I2C
@@ -533,6 +737,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 	#define TIMER8_USE_TM2       1
 	#define TIMER8_USE_TM3       1
 	#define TIMER8_SOLVER_ENABLE 1  // CHECK HEADER FOR RESOURCE USAGE!
+	#define TIMER8_LIVE_UPDATE   0  // 1: Stage parameters, load with TimerX_Commit from interrupt
+	#define TIMER8_SOLVER_REPORT 1  // 1: Solver writes timer8_actual_freq and timer8_error_ppm
+	#define TIMER8_SOLVE_PPM     0  // Default timer8_solve_ppm. 0: Best result; Other: First within ppm
 
 
 	// TIMER 2
@@ -542,6 +749,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 	#define TIMER8_2_OUT    PB2         // Ex: Disable, PB2, PA3, PB4
 	#define TIMER8_2_6BIT   0           // 0: 8-bit PWM;           1: 6-bit PWM
 	#define TIMER8_2_INV    0           // 0: Out polarity normal; 1: Out polarity inverted
+	#define TIMER8_2_TARGET 0           // Hz. 0: Set at run time; Other: Solved at build time
+	#define TIMER8_2_DUTY   50          // [1 : 100]. PWM mode with build time target only
+	#define TIMER8_2_PRESETS 0          // Entries in ROM preset table, see tools/preset_gen.cpp
 
 
 	// TIMER 3
@@ -551,6 +761,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 	#define TIMER8_3_OUT    PB6
 	#define TIMER8_3_6BIT   1
 	#define TIMER8_3_INV    1
+	#define TIMER8_3_TARGET 0
+	#define TIMER8_3_DUTY   50
+	#define TIMER8_3_PRESETS 0
 
 
     ///////////////////////////
@@ -569,9 +782,11 @@ Copyright (c) 2021 Robert R. Puccinelli
 
 
 	#if TIMER8_2_6BIT
-		#define TIMER8_2_RES 0b10000000
+		#define TIMER8_2_RES   0b10000000
+		#define TIMER8_2_DEPTH 64
 	#else
-		#define TIMER8_2_RES 0b00000000
+		#define TIMER8_2_RES   0b00000000
+		#define TIMER8_2_DEPTH 256
 	#endif
 
 
@@ -583,9 +798,11 @@ Copyright (c) 2021 Robert R. Puccinelli
 
 
 	#if TIMER8_3_6BIT
-		#define TIMER8_3_RES 0b10000000
+		#define TIMER8_3_RES   0b10000000
+		#define TIMER8_3_DEPTH 64
 	#else
-		#define TIMER8_3_RES 0b00000000
+		#define TIMER8_3_RES   0b00000000
+		#define TIMER8_3_DEPTH 256
 	#endif
 
 	#if TIMER8_3_INV
@@ -595,6 +812,96 @@ Copyright (c) 2021 Robert R. Puccinelli
 	#endif
 
 
+	// Build time solver for TIMER8_2_TARGET. Same search as the run time solver,
+	// but takes the smallest scalar that fits instead of scanning every scalar.
+	#if TIMER8_2_TARGET
+		#ifidni TIMER8_2_MODE, PWM
+			#define TIMER8_2_RATIO      (TIMER8_2_HZ / TIMER8_2_DEPTH / TIMER8_2_TARGET)
+			#define TIMER8_2_LIMIT      32
+		#else
+			#define TIMER8_2_RATIO      (TIMER8_2_HZ / TIMER8_2_TARGET / 2)
+			#define TIMER8_2_LIMIT      8192
+		#endif
+
+		#if     (TIMER8_2_RATIO)      <= TIMER8_2_LIMIT
+			#define TIMER8_2_BUILD_PRE  0b00000000
+			#define TIMER8_2_SCALED     (TIMER8_2_RATIO)
+		#elseif (TIMER8_2_RATIO / 4)  <= TIMER8_2_LIMIT
+			#define TIMER8_2_BUILD_PRE  0b00100000
+			#define TIMER8_2_SCALED     (TIMER8_2_RATIO / 4)
+		#elseif (TIMER8_2_RATIO / 16) <= TIMER8_2_LIMIT
+			#define TIMER8_2_BUILD_PRE  0b01000000
+			#define TIMER8_2_SCALED     (TIMER8_2_RATIO / 16)
+		#elseif (TIMER8_2_RATIO / 64) <= TIMER8_2_LIMIT
+			#define TIMER8_2_BUILD_PRE  0b01100000
+			#define TIMER8_2_SCALED     (TIMER8_2_RATIO / 64)
+		#else
+			.error TIMER8_2_TARGET is too low for TIMER8_2_HZ!
+		#endif
+
+		#if (TIMER8_2_SCALED) < 1
+			.error TIMER8_2_TARGET is too high for TIMER8_2_HZ!
+		#endif
+
+		#ifidni TIMER8_2_MODE, PWM
+			#if (TIMER8_2_DUTY > 100) || ((TIMER8_2_DUTY * TIMER8_2_DEPTH) < 100)
+				.error TIMER8_2_DUTY is out of range!
+			#endif
+			#define TIMER8_2_BUILD_SCL  (TIMER8_2_SCALED - 1)
+			#define TIMER8_2_BUILD_BND  ((TIMER8_2_DUTY * TIMER8_2_DEPTH / 100) - 1)
+		#else
+			#define TIMER8_2_STEP       ((TIMER8_2_SCALED + 255) / 256)
+			#define TIMER8_2_BUILD_SCL  (TIMER8_2_STEP - 1)
+			#define TIMER8_2_BUILD_BND  (((TIMER8_2_SCALED + (TIMER8_2_STEP / 2)) / TIMER8_2_STEP) - 1)
+		#endif
+	#endif
+
+
+	// Build time solver for TIMER8_3_TARGET. Same search as the run time solver,
+	// but takes the smallest scalar that fits instead of scanning every scalar.
+	#if TIMER8_3_TARGET
+		#ifidni TIMER8_3_MODE, PWM
+			#define TIMER8_3_RATIO      (TIMER8_3_HZ / TIMER8_3_DEPTH / TIMER8_3_TARGET)
+			#define TIMER8_3_LIMIT      32
+		#else
+			#define TIMER8_3_RATIO      (TIMER8_3_HZ / TIMER8_3_TARGET / 2)
+			#define TIMER8_3_LIMIT      8192
+		#endif
+
+		#if     (TIMER8_3_RATIO)      <= TIMER8_3_LIMIT
+			#define TIMER8_3_BUILD_PRE  0b00000000
+			#define TIMER8_3_SCALED     (TIMER8_3_RATIO)
+		#elseif (TIMER8_3_RATIO / 4)  <= TIMER8_3_LIMIT
+			#define TIMER8_3_BUILD_PRE  0b00100000
+			#define TIMER8_3_SCALED     (TIMER8_3_RATIO / 4)
+		#elseif (TIMER8_3_RATIO / 16) <= TIMER8_3_LIMIT
+			#define TIMER8_3_BUILD_PRE  0b01000000
+			#define TIMER8_3_SCALED     (TIMER8_3_RATIO / 16)
+		#elseif (TIMER8_3_RATIO / 64) <= TIMER8_3_LIMIT
+			#define TIMER8_3_BUILD_PRE  0b01100000
+			#define TIMER8_3_SCALED     (TIMER8_3_RATIO / 64)
+		#else
+			.error TIMER8_3_TARGET is too low for TIMER8_3_HZ!
+		#endif
+
+		#if (TIMER8_3_SCALED) < 1
+			.error TIMER8_3_TARGET is too high for TIMER8_3_HZ!
+		#endif
+
+		#ifidni TIMER8_3_MODE, PWM
+			#if (TIMER8_3_DUTY > 100) || ((TIMER8_3_DUTY * TIMER8_3_DEPTH) < 100)
+				.error TIMER8_3_DUTY is out of range!
+			#endif
+			#define TIMER8_3_BUILD_SCL  (TIMER8_3_SCALED - 1)
+			#define TIMER8_3_BUILD_BND  ((TIMER8_3_DUTY * TIMER8_3_DEPTH / 100) - 1)
+		#else
+			#define TIMER8_3_STEP       ((TIMER8_3_SCALED + 255) / 256)
+			#define TIMER8_3_BUILD_SCL  (TIMER8_3_STEP - 1)
+			#define TIMER8_3_BUILD_BND  (((TIMER8_3_SCALED + (TIMER8_3_STEP / 2)) / TIMER8_3_STEP) - 1)
+		#endif
+	#endif
+
+
 	/////////////////////////
     // DO NOT TOUCH -- END //
     /////////////////////////
@@ -611,6 +918,11 @@ Copyright (c) 2021 Robert R. Puccinelli
 	#define PWM_USE_G1 1
 	#define PWM_USE_G2 1
 	#define PWM_SOLVER_ENABLE 1  // CHECK HEADER FOR RESOURCE USAGE!
+	#define PWM_LIVE_UPDATE   0  // 1: Stage parameters, load with PWM11_X_Commit from interrupt
+	#define PWM_SOLVER_REPORT 1  // 1: Solver writes pwm11_actual_freq and pwm11_error_ppm
+	#define PWM_SOLVE_PPM     0  // Default pwm11_solve_ppm. 0: Best result; Other: First within ppm
+	#define PWM_SOLVE_GLOBAL  0  // 1: Search every prescaler for the closest result, ~2.5 ms
+	#define PWM_DITHER        0  // 1: 16-bit duty with PWM11_X_Set_Duty16, PWM11_X_Dither per period
 
 
 	// PWM 0
@@ -619,6 +931,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 	#define PWM_0_OUTPUT    PB4          // Disable, PB5, PA0, PB4
 	#define PWM_0_INV       0            // Invert PWM output, 0/1
 	#define PWM_0_INT_ZERO  0            // Interrupt at zero or duty, 0/1
+	#define PWM_0_TARGET    0            // Hz. 0: Set at run time; Other: Solved at build time
+	#define PWM_0_DUTY      50           // [0 : 100]. Build time target only
+	#define PWM_0_PRESETS   0            // Entries in ROM preset table, see tools/preset_gen.cpp
 
 
 	// PWM 1
@@ -627,6 +942,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 	#define PWM_1_OUTPUT    PA4
 	#define PWM_1_INV       0
 	#define PWM_1_INT_ZERO  0            // INTERUPT ONLY SUPPORTED ON G0
+	#define PWM_1_TARGET    0
+	#define PWM_1_DUTY      50
+	#define PWM_1_PRESETS   0
 
 
 	// PWM 2
@@ -635,6 +953,9 @@ Copyright (c) 2021 Robert R. Puccinelli
 	#define PWM_2_OUTPUT    PB3
 	#define PWM_2_INV       1
 	#define PWM_2_INT_ZERO  0            // INTERUPT ONLY SUPPORTED ON G0
+	#define PWM_2_TARGET    0
+	#define PWM_2_DUTY      50
+	#define PWM_2_PRESETS   0
 
 
     ///////////////////////////
@@ -707,6 +1028,133 @@ Copyright (c) 2021 Robert R. Puccinelli
 		#define PWM_2_INT 0b00000000
 	#endif
 
+
+	#if PWM_DITHER
+		#ifz PERIPH_MATH
+			.error PWM_DITHER requires PERIPH_MATH to be enabled!
+		#endif
+	#endif
+
+
+	// Build time solver for PWM_0_TARGET. Same search as the run time solver,
+	// but takes the smallest scalar that fits instead of scanning every scalar.
+	#if PWM_0_TARGET
+		#define PWM_0_RATIO  (PWM_0_CLK_HZ / PWM_0_TARGET * 2)  // x2, see pdk_pwm_11b.c
+
+		#if     (PWM_0_RATIO)      <= 65504
+			#define PWM_0_BUILD_PRE  0b0000000
+			#define PWM_0_SCALED     (PWM_0_RATIO)
+		#elseif (PWM_0_RATIO / 4)  <= 65504
+			#define PWM_0_BUILD_PRE  0b0100000
+			#define PWM_0_SCALED     (PWM_0_RATIO / 4)
+		#elseif (PWM_0_RATIO / 16) <= 65504
+			#define PWM_0_BUILD_PRE  0b1000000
+			#define PWM_0_SCALED     (PWM_0_RATIO / 16)
+		#elseif (PWM_0_RATIO / 64) <= 65504
+			#define PWM_0_BUILD_PRE  0b1100000
+			#define PWM_0_SCALED     (PWM_0_RATIO / 64)
+		#else
+			.error PWM_0_TARGET is too low for PWM_0_CLK_HZ!
+		#endif
+
+		#if (PWM_0_SCALED) < 1
+			.error PWM_0_TARGET is too high for PWM_0_CLK_HZ!
+		#endif
+
+		#if PWM_0_DUTY > 100
+			.error PWM_0_DUTY is out of range!
+		#endif
+
+		// Counter + 1 must be odd and no larger than 2047. Nearest odd count to
+		// SCALED / STEP, so the period is off by at most one count, i.e. one
+		// part in PWM_0_PERIOD: 0.05% at 2047 counts, 33% at 3.
+		#define PWM_0_STEP       ((PWM_0_SCALED + 2046) / 2047)
+		#define PWM_0_PERIOD     (((PWM_0_SCALED / (2 * PWM_0_STEP)) * 2) + 1)
+		#define PWM_0_BUILD_SCL  (PWM_0_STEP - 1)
+		#define PWM_0_BUILD_CNT  (PWM_0_PERIOD - 1)
+		#define PWM_0_BUILD_DUTY (((PWM_0_DUTY * PWM_0_PERIOD) + 50) / 100)
+	#endif
+
+
+	// Build time solver for PWM_1_TARGET. Same search as the run time solver,
+	// but takes the smallest scalar that fits instead of scanning every scalar.
+	#if PWM_1_TARGET
+		#define PWM_1_RATIO  (PWM_1_CLK_HZ / PWM_1_TARGET * 2)  // x2, see pdk_pwm_11b.c
+
+		#if     (PWM_1_RATIO)      <= 65504
+			#define PWM_1_BUILD_PRE  0b0000000
+			#define PWM_1_SCALED     (PWM_1_RATIO)
+		#elseif (PWM_1_RATIO / 4)  <= 65504
+			#define PWM_1_BUILD_PRE  0b0100000
+			#define PWM_1_SCALED     (PWM_1_RATIO / 4)
+		#elseif (PWM_1_RATIO / 16) <= 65504
+			#define PWM_1_BUILD_PRE  0b1000000
+			#define PWM_1_SCALED     (PWM_1_RATIO / 16)
+		#elseif (PWM_1_RATIO / 64) <= 65504
+			#define PWM_1_BUILD_PRE  0b1100000
+			#define PWM_1_SCALED     (PWM_1_RATIO / 64)
+		#else
+			.error PWM_1_TARGET is too low for PWM_1_CLK_HZ!
+		#endif
+
+		#if (PWM_1_SCALED) < 1
+			.error PWM_1_TARGET is too high for PWM_1_CLK_HZ!
+		#endif
+
+		#if PWM_1_DUTY > 100
+			.error PWM_1_DUTY is out of range!
+		#endif
+
+		// Counter + 1 must be odd and no larger than 2047. Nearest odd count to
+		// SCALED / STEP, so the period is off by at most one count, i.e. one
+		// part in PWM_1_PERIOD: 0.05% at 2047 counts, 33% at 3.
+		#define PWM_1_STEP       ((PWM_1_SCALED + 2046) / 2047)
+		#define PWM_1_PERIOD     (((PWM_1_SCALED / (2 * PWM_1_STEP)) * 2) + 1)
+		#define PWM_1_BUILD_SCL  (PWM_1_STEP - 1)
+		#define PWM_1_BUILD_CNT  (PWM_1_PERIOD - 1)
+		#define PWM_1_BUILD_DUTY (((PWM_1_DUTY * PWM_1_PERIOD) + 50) / 100)
+	#endif
+
+
+	// Build time solver for PWM_2_TARGET. Same search as the run time solver,
+	// but takes the smallest scalar that fits instead of scanning every scalar.
+	#if PWM_2_TARGET
+		#define PWM_2_RATIO  (PWM_2_CLK_HZ / PWM_2_TARGET * 2)  // x2, see pdk_pwm_11b.c
+
+		#if     (PWM_2_RATIO)      <= 65504
+			#define PWM_2_BUILD_PRE  0b0000000
+			#define PWM_2_SCALED     (PWM_2_RATIO)
+		#elseif (PWM_2_RATIO / 4)  <= 65504
+			#define PWM_2_BUILD_PRE  0b0100000
+			#define PWM_2_SCALED     (PWM_2_RATIO / 4)
+		#elseif (PWM_2_RATIO / 16) <= 65504
+			#define PWM_2_BUILD_PRE  0b1000000
+			#define PWM_2_SCALED     (PWM_2_RATIO / 16)
+		#elseif (PWM_2_RATIO / 64) <= 65504
+			#define PWM_2_BUILD_PRE  0b1100000
+			#define PWM_2_SCALED     (PWM_2_RATIO / 64)
+		#else
+			.error PWM_2_TARGET is too low for PWM_2_CLK_HZ!
+		#endif
+
+		#if (PWM_2_SCALED) < 1
+			.error PWM_2_TARGET is too high for PWM_2_CLK_HZ!
+		#endif
+
+		#if PWM_2_DUTY > 100
+			.error PWM_2_DUTY is out of range!
+		#endif
+
+		// Counter + 1 must be odd and no larger than 2047. Nearest odd count to
+		// SCALED / STEP, so the period is off by at most one count, i.e. one
+		// part in PWM_2_PERIOD: 0.05% at 2047 counts, 33% at 3.
+		#define PWM_2_STEP       ((PWM_2_SCALED + 2046) / 2047)
+		#define PWM_2_PERIOD     (((PWM_2_SCALED / (2 * PWM_2_STEP)) * 2) + 1)
+		#define PWM_2_BUILD_SCL  (PWM_2_STEP - 1)
+		#define PWM_2_BUILD_CNT  (PWM_2_PERIOD - 1)
+		#define PWM_2_BUILD_DUTY (((PWM_2_DUTY * PWM_2_PERIOD) + 50) / 100)
+	#endif
+
     /////////////////////////
     // DO NOT TOUCH -- END //
     /////////////////////////
@@ -795,4 +1243,93 @@ Copyright (c) 2021 Robert R. Puccinelli
 #endif
 
 
+//=====================//
+// SOFTWARE POSTSCALER //
+//=====================//
+
+#ifidni PERIPH_POSTSCL, 1
+
+	// NOTE: POSTSCALER WILL OVERWRITE THE TM2, TM3, OR PWM0 SETTINGS ABOVE!!
+	//       Timer output pin, mode, AND autosolver will be overwritten.
+	//       Do not share the timer source with PERIPH_STEPPER.
+
+	#define POST_PIN        PA.5   // Output, toggled by the tick interrupt
+	#define POST_TIMER_SRC  TM2    // TM2, TM3 or PWM0 due to availability of interrupts
+	#define POST_TICK_HZ    1000   // Tick interrupt rate [2 : 10000], even. Higher is finer
+
+
+    ///////////////////////////
+    // DO NOT TOUCH -- START //
+    ///////////////////////////
+	#ifidni     POST_TIMER_SRC, TM2
+		#undef  TIMER8_USE_TM2
+		#undef  TIMER8_SOLVER_ENABLE
+		#undef  TIMER8_2_OUT
+		#undef  TIMER8_2_MODE
+		#undef  TIMER8_2_TARGET
+
+		#define TIMER8_USE_TM2       1
+		#define TIMER8_SOLVER_ENABLE 1
+		#define TIMER8_2_OUT   Disable
+		#define TIMER8_2_MODE  Period
+		#define TIMER8_2_TARGET 0
+		#define POST_INTR      INTR_TM2
+
+		#ifz PERIPH_TIMER8
+			.error PERIPH_POSTSCL requires PERIPH_TIMER8 to be enabled!
+		#endif
+
+	#elseifidni POST_TIMER_SRC, TM3
+		#undef  TIMER8_USE_TM3
+		#undef  TIMER8_SOLVER_ENABLE
+		#undef  TIMER8_3_OUT
+		#undef  TIMER8_3_MODE
+		#undef  TIMER8_3_TARGET
+
+		#define TIMER8_USE_TM3       1
+		#define TIMER8_SOLVER_ENABLE 1
+		#define TIMER8_3_OUT   Disable
+		#define TIMER8_3_MODE  Period
+		#define TIMER8_3_TARGET 0
+		#define POST_INTR      INTR_TM3
+
+		#ifz PERIPH_TIMER8
+			.error PERIPH_POSTSCL requires PERIPH_TIMER8 to be enabled!
+		#endif
+
+	#elseifidni POST_TIMER_SRC, PWM0
+		#undef  PWM_USE_G0
+		#undef  PWM_SOLVER_ENABLE
+		#undef  PWM_0_OUTPUT
+		#undef  PWM_0_TARGET
+
+		#define PWM_USE_G0        1
+		#define PWM_SOLVER_ENABLE 1
+		#define PWM_0_OUTPUT   Disable
+		#define PWM_0_TARGET   0
+		#define POST_INTR      INTR_PWM
+
+		#ifz PERIPH_PWM_11B
+			.error PERIPH_POSTSCL requires PERIPH_PWM_11B to be enabled!
+		#endif
+	#endif
+
+	#if (POST_TICK_HZ < 2) || (POST_TICK_HZ > 10000)
+		.error POST_TICK_HZ must be [2 : 10000]!
+	#endif
+
+	#if (POST_TICK_HZ / 2 * 2) != POST_TICK_HZ
+		.error POST_TICK_HZ must be even!
+	#endif
+
+	#ifz PERIPH_MATH
+		.error PERIPH_POSTSCL requires PERIPH_MATH to be enabled!
+	#endif
+
+    /////////////////////////
+    // DO NOT TOUCH -- END //
+    /////////////////////////
+#endif
+
+
 #endif // SYSTEM_SETTINGS_H
\ No newline at end of file
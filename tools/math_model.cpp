@@ -0,0 +1,1026 @@
+/* math_model.cpp
+
+Host model of pdk_math.c for checking changes without the IDE or an ICE.
+The static scratch block is modelled byte for byte, with the same aliases,
+so routines that share bytes corrupt each other here exactly as they would
+on the chip. Every routine is run against a reference result, exhaustively
+where the input space is small and on random and edge operands otherwise.
+Both the mul instruction and the shift-and-add paths are checked.
+
+Cycle counts are estimates. Each modelled statement is charged the
+instructions the Mini-C compiler emits for it (byte move 2, N-byte add or
+subtract 2N, N-byte compare 2N + 2, shift 1 per byte, loop 3, call and
+ret 4, taken skip 2). The worst case is printed in us at 4 cycles per us,
+the rate the run time table in pdk_math.h is quoted at.
+
+Build:
+	g++ -std=c++11 -O2 -o math_model math_model.cpp
+
+Usage:
+	math_model [random cases, default 200000]
+
+Exit status is 0 when every check passes. Keep this file in step with
+pdk_math.c when a routine changes.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+
+//=====//
+// RAM //
+//=====//
+
+// The scratch block sits in a modelled RAM so that a runaway pointer write
+// from bcd_unpack lands somewhere that is checked.
+static uint8_t ram[256];
+
+static const unsigned BLOCK    = 0x10;          // math_byte1, math_dword1..4
+static const unsigned BYTE1    = BLOCK;
+static const unsigned DWORD1   = BLOCK + 1;
+static const unsigned DWORD2   = BLOCK + 5;
+static const unsigned DWORD3   = BLOCK + 9;
+static const unsigned DWORD4   = BLOCK + 13;
+static const unsigned BUF      = 0x40;          // bcd_unpack destination
+
+static bool     has_mul;                        // HAS_MULTIPLIER
+static uint8_t  mulop, mulrh;
+static unsigned cf;                             // Carry flag
+static unsigned long cycles;
+static bool     runaway;                        // A loop ran past CYCLE_LIMIT
+
+static const unsigned long CYCLE_LIMIT = 100000;
+
+
+// N-byte little endian variable at a RAM address
+struct Var
+{
+	unsigned addr, n;
+
+	uint64_t get() const
+	{
+		uint64_t v = 0;
+		for (unsigned i = n; i--; ) v = (v << 8) | ram[addr + i];
+		return v;
+	}
+
+	void set(uint64_t v) const
+	{
+		for (unsigned i = 0; i < n; i++) { ram[addr + i] = v & 0xFF; v >>= 8; }
+	}
+
+	Var     b(unsigned i) const { Var r = { addr + i, 1 }; return r; }
+	uint8_t &at(unsigned i) const { return ram[addr + i]; }
+	uint64_t mask() const { return (n >= 8) ? ~0ULL : ((1ULL << (8 * n)) - 1); }
+};
+
+
+//=========//
+// ALIASES //
+//=========//
+
+static const Var math_dividend  = { DWORD1, 4 };
+static const Var math_quotient  = { DWORD1, 4 };
+static const Var math_product   = { DWORD1, 4 };
+static const Var math_bcd_ptr   = { DWORD1, 2 };
+static const Var product_hi     = { DWORD1 + 2, 2 };
+
+static const Var math_dword2    = { DWORD2, 4 };
+static const Var math_product_h = { DWORD2, 4 };
+static const Var math_root      = { DWORD2, 2 };
+static const Var math_bcd       = { DWORD2, 4 };
+static const Var recip_xn       = { DWORD2, 2 };
+static const Var recip_r        = { DWORD2 + 2, 2 };
+
+static const Var math_divisor   = { DWORD3, 3 };
+static const Var math_mult_a    = { DWORD3, 2 };
+static const Var math_mult_da   = { DWORD3, 4 };
+static const Var math_bcd_h     = { DWORD3, 1 };
+static const Var bcd_count      = { DWORD3 + 1, 1 };
+static const Var recip_shift    = { DWORD3 + 2, 1 };
+
+static const Var math_remainder = { DWORD4, 3 };
+static const Var math_mult_b    = { DWORD4, 2 };
+static const Var math_mult_db   = { DWORD4, 4 };
+static const Var math_dword4    = { DWORD4, 4 };
+static const Var bcd_digit      = { DWORD4, 1 };
+
+static const Var counter        = { BYTE1, 1 };
+static const Var math_shift     = { BYTE1, 1 };
+static const Var product_x      = { BYTE1, 1 };
+
+
+//===========================//
+// INSTRUCTION LEVEL HELPERS //
+//===========================//
+
+static void Tick(unsigned n) { cycles += n; }
+
+// sl / slc / src on one byte
+static void Sl(uint8_t &b)  { cf = b >> 7; b = (uint8_t)(b << 1); Tick(1); }
+static void Slc(uint8_t &b) { unsigned c = b >> 7; b = (uint8_t)((b << 1) | cf); cf = c; Tick(1); }
+static void Src(uint8_t &b) { unsigned c = b & 1; b = (uint8_t)((b >> 1) | (cf << 7)); cf = c; Tick(1); }
+
+// N-byte ops, carry out of the top byte lands in cf
+static void Add(const Var &v, uint64_t x)
+{
+	uint64_t r = v.get() + (x & v.mask());
+	cf = (r >> (8 * v.n)) & 1;
+	v.set(r);
+	Tick(2 * v.n);
+}
+
+static void Sub(const Var &v, uint64_t x)
+{
+	uint64_t a = v.get(), b = x & v.mask();
+	cf = a < b;
+	v.set(a - b);
+	Tick(2 * v.n);
+}
+
+static void Mov(const Var &v, uint64_t x) { v.set(x); Tick(2 * v.n); }
+
+static void Shr(const Var &v) { cf = v.get() & 1; v.set(v.get() >> 1); Tick(v.n); }
+static void Shl(const Var &v) { cf = (v.get() >> (8 * v.n - 1)) & 1; v.set(v.get() << 1); Tick(v.n); }
+
+static bool Cmp_Ge(uint64_t a, uint64_t b, unsigned n) { Tick(2 * n + 2); return a >= b; }
+
+// do { } while (--counter). Stops a loop whose counter was overwritten.
+static bool Loop(const Var &c)
+{
+	c.at(0)--;
+	Tick(3);
+	if (cycles > CYCLE_LIMIT) runaway = true;
+	return (c.at(0) != 0) && !runaway;
+}
+
+// mul, A = low byte of mulop x A, mulrh = high byte
+static uint8_t Mul_Lo(uint8_t a) { unsigned p = mulop * a; mulrh = p >> 8; Tick(1); return p & 0xFF; }
+
+
+//========//
+// MACROS //
+//========//
+
+static void Product_Shift_Byte(void)
+{
+	for (unsigned i = 0; i < 3; i++) math_product.at(i) = math_product.at(i + 1);
+	math_product.at(3) = math_product_h.at(0);
+	for (unsigned i = 0; i < 3; i++) math_product_h.at(i) = math_product_h.at(i + 1);
+	math_product_h.at(3) = product_x.at(0);
+	product_x.at(0) = 0;
+	Tick(17);
+}
+
+
+static void Magic_Row(uint8_t xb)
+{
+	mulop = xb;
+	for (unsigned i = 0; i < 3; i++)
+	{
+		uint8_t a = Mul_Lo(math_divisor.at(i));
+		Add(math_dword2, (uint64_t)a << (8 * i));
+		Add(math_dword2, (uint64_t)mulrh << (8 * (i + 1)));
+	}
+	math_dword2.set(math_dword2.get() >> 8);
+	Tick(7);
+}
+
+
+// Byte-wise add with carry into the byte chain, as Product_Row spells it out
+static void Addc_Chain(unsigned first, uint8_t lo, uint8_t hi)
+{
+	uint8_t *h[5] = { &math_product_h.at(0), &math_product_h.at(1), &math_product_h.at(2),
+	                  &math_product_h.at(3), &product_x.at(0) };
+	unsigned s = *h[first] + lo;
+	*h[first] = s & 0xFF;
+	unsigned c = s >> 8;
+	s = hi + c;                                // A = mulrh; addc A
+	unsigned a = s & 0xFF;
+	c = s >> 8;
+	s = *h[first + 1] + a;
+	*h[first + 1] = s & 0xFF;
+	c = s >> 8;
+	Tick(5);
+	for (unsigned i = first + 2; i < 5; i++)
+	{
+		s = *h[i] + c;
+		*h[i] = s & 0xFF;
+		c = s >> 8;
+		Tick(1);
+	}
+}
+
+
+static void Product_Row(uint8_t ab)
+{
+	mulop = ab;
+	for (unsigned i = 0; i < 4; i++)
+	{
+		uint8_t a = Mul_Lo(math_mult_db.at(i));
+		Addc_Chain(i, a, mulrh);
+	}
+	Product_Shift_Byte();
+}
+
+
+static void BCD_Adjust(uint8_t &b)
+{
+	Tick(2);
+	if (b)
+	{
+		Tick(4);
+		if ((b & 0x0F) >= 0x05) { b += 0x03; Tick(2); }
+		Tick(3);
+		if (b >= 0x50) { b += 0x30; Tick(2); }
+	}
+}
+
+
+static void BCD_Shift(void)
+{
+	for (unsigned i = 0; i < 4; i++) Slc(math_bcd.at(i));
+	Slc(math_bcd_h.at(0));
+}
+
+
+static void Product_Shift_Add(void)
+{
+	Shr(math_mult_da);
+	if (cf) Add(math_product_h, math_mult_db.get());
+	Tick(2);
+	for (unsigned i = 4; i--; ) Src(math_product_h.at(i));
+	for (unsigned i = 4; i--; ) Src(math_product.at(i));
+}
+
+
+//==========//
+// ROUTINES //
+//==========//
+
+static void Call(void) { Tick(4); }
+
+
+static void byte_divide(void)
+{
+	Call();
+	Mov(counter, 8);
+	Mov(math_remainder, 0);
+
+	if (!Cmp_Ge(math_dividend.get(), math_divisor.get(), 4))
+	{
+		Mov(math_remainder, math_dividend.get());
+		Mov(math_quotient, 0);
+		return;
+	}
+
+	do
+	{
+		Sl(math_dividend.at(0));
+		Slc(math_remainder.at(0));
+		if (Cmp_Ge(math_remainder.at(0), math_divisor.at(0), 1))
+		{
+			math_remainder.at(0) -= math_divisor.at(0);
+			math_quotient.at(0) |= 1;
+			Tick(3);
+		}
+	} while (Loop(counter));
+}
+
+
+// word, eword and dword divide differ in width and the leading zero skip
+static void Divide(unsigned width, bool skip)
+{
+	Call();
+	Mov(counter, 8 * width);
+	Mov(math_remainder, 0);
+
+	if (!Cmp_Ge(math_dividend.get(), math_divisor.get(), 4))
+	{
+		Mov(math_remainder, math_dividend.get());
+		Mov(math_quotient, 0);
+		return;
+	}
+
+	if (skip)
+	{
+		unsigned top = width - 1;
+		while (Tick(4), !math_dividend.at(top) && (counter.at(0) > 8))
+		{
+			for (unsigned i = top; i > 0; i--) math_dividend.at(i) = math_dividend.at(i - 1);
+			math_dividend.at(0) = 0;
+			counter.at(0) -= 8;
+			Tick(2 * width + 3);
+		}
+	}
+
+	unsigned rem_bytes = (width < 3) ? width : 3;
+	do
+	{
+		Sl(math_dividend.at(0));
+		for (unsigned i = 1; i < width; i++) Slc(math_dividend.at(i));
+		for (unsigned i = 0; i < rem_bytes; i++) Slc(math_remainder.at(i));
+
+		// dword_divide takes a carry out of the remainder as a subtract
+		if (((width == 4) && (Tick(2), cf)) || Cmp_Ge(math_remainder.get(), math_divisor.get(), 3))
+		{
+			Sub(math_remainder, math_divisor.get());
+			math_quotient.at(0) |= 1;
+			Tick(1);
+		}
+	} while (Loop(counter));
+}
+
+static void word_divide(void)  { Divide(2, false); }
+static void eword_divide(void) { Divide(3, true); }
+static void dword_divide(void) { Divide(4, true); }
+
+
+static void eword_magic_divide(void)
+{
+	Call();
+	math_remainder.at(0) = math_dividend.at(3);
+	math_remainder.at(1) = math_dividend.at(0);
+	math_remainder.at(2) = 0;
+	math_dividend.at(3)  = 0;
+	Tick(7);
+	Mov(math_dword2, 0);
+
+	Magic_Row(math_dividend.at(0));
+	Magic_Row(math_dividend.at(1));
+	Magic_Row(math_dividend.at(2));
+
+	Sub(math_dividend, math_dword2.get());
+	Shr(math_dividend);
+	Add(math_dividend, math_dword2.get());
+	while (Loop(counter)) Shr(math_dividend);
+
+	mulop = math_remainder.at(0);
+	uint8_t a = Mul_Lo(math_quotient.at(0));
+	math_remainder.at(1) -= a;
+	math_remainder.at(0) = math_remainder.at(1);
+	math_remainder.at(1) = 0;
+	Tick(6);
+}
+
+
+// Eword_Divide_Const macro, magic number solved as the preprocessor does
+static void Eword_Divide_Const(unsigned d)
+{
+	if (!has_mul)
+	{
+		Mov(math_divisor, d);
+		eword_divide();
+		return;
+	}
+
+	unsigned l = 1;
+	while ((1u << l) < d) l++;
+	Mov(math_divisor, ((((1ULL << l) - d) << 24) / d) + 1);
+	Mov(math_dividend.b(3), d);
+	Mov(math_shift, l);
+	eword_magic_divide();
+}
+
+
+static void byte_multiply(void)
+{
+	Call();
+	Mov(math_product, 0);
+	if (has_mul)
+	{
+		mulop = math_mult_a.at(0);
+		math_product.at(0) = Mul_Lo(math_mult_b.at(0));
+		math_product.at(1) = mulrh;
+		Tick(4);
+		return;
+	}
+
+	Mov(counter, 8);
+	do
+	{
+		Shr(math_mult_a.b(0));
+		if (cf) Add(math_product, (uint64_t)math_mult_b.at(0) << 8);
+		Tick(2);
+		Shr(math_product);
+	} while (Loop(counter));
+}
+
+
+static void word_multiply(void)
+{
+	Call();
+	Mov(math_product, 0);
+	if (has_mul)
+	{
+		mulop = math_mult_a.at(0);
+		math_product.at(0) = Mul_Lo(math_mult_b.at(0));
+		math_product.at(1) = mulrh;
+		Tick(4);
+
+		uint8_t a = Mul_Lo(math_mult_b.at(1));
+		Add(math_product, (uint64_t)a << 8);
+		Add(math_product, (uint64_t)mulrh << 16);
+
+		mulop = math_mult_a.at(1);
+		a = Mul_Lo(math_mult_b.at(0));
+		Add(math_product, (uint64_t)a << 8);
+		Add(math_product, (uint64_t)mulrh << 16);
+
+		a = Mul_Lo(math_mult_b.at(1));
+		Add(math_product, (uint64_t)a << 16);
+		Add(math_product, (uint64_t)mulrh << 24);
+		Tick(4);
+		return;
+	}
+
+	Mov(counter, 16);
+	do
+	{
+		Shr(math_mult_a);
+		if (cf) Add(math_product, math_mult_b.get() << 16);
+		Tick(2);
+		for (unsigned i = 4; i--; ) Src(math_product.at(i));  // >>>= takes the add carry
+	} while (Loop(counter));
+}
+
+
+static void eword_multiply(void)
+{
+	Call();
+	Mov(math_product, 0);
+	Mov(math_product_h, 0);
+	Mov(product_x, 0);
+	Mov(math_mult_db.b(3), 0);
+	if (has_mul)
+	{
+		uint8_t da[3] = { math_mult_da.at(0), math_mult_da.at(1), math_mult_da.at(2) };
+		for (unsigned i = 0; i < 3; i++) Product_Row(da[i]);
+	}
+	else
+	{
+		Mov(math_mult_da.b(3), 0);
+		Mov(counter, 24);
+		do Product_Shift_Add();
+		while (Loop(counter));
+	}
+	Product_Shift_Byte();
+}
+
+
+static void dword_multiply(void)
+{
+	Call();
+	Mov(math_product, 0);
+	Mov(math_product_h, 0);
+	Mov(product_x, 0);
+	if (has_mul)
+	{
+		uint8_t da[4] = { math_mult_da.at(0), math_mult_da.at(1), math_mult_da.at(2), math_mult_da.at(3) };
+		for (unsigned i = 0; i < 4; i++) Product_Row(da[i]);
+	}
+	else
+	{
+		Mov(counter, 32);
+		do Product_Shift_Add();
+		while (Loop(counter));
+	}
+}
+
+
+static void Sqrt_Bits(void)
+{
+	Call();
+	Mov(math_remainder, 0);
+	Mov(math_root, 0);
+
+	do
+	{
+		for (unsigned k = 0; k < 2; k++)
+		{
+			Sl(math_dividend.at(0));
+			for (unsigned i = 1; i < 4; i++) Slc(math_dividend.at(i));
+			for (unsigned i = 0; i < 3; i++) Slc(math_remainder.at(i));
+		}
+
+		Shl(math_root);
+		Mov(math_divisor, math_root.get());
+		Shl(math_divisor);
+		math_divisor.at(0) |= 1;
+		Tick(1);
+
+		if (Cmp_Ge(math_remainder.get(), math_divisor.get(), 3))
+		{
+			Sub(math_remainder, math_divisor.get());
+			math_root.at(0) |= 1;
+			Tick(1);
+		}
+	} while (Loop(counter));
+}
+
+
+static void word_sqrt(void)
+{
+	Call();
+	math_dividend.at(2) = math_dividend.at(0);
+	math_dividend.at(3) = math_dividend.at(1);
+	Tick(4);
+	Mov(counter, 8);
+	Sqrt_Bits();
+}
+
+
+static void dword_sqrt(void)
+{
+	Call();
+	Mov(counter, 16);
+	Sqrt_Bits();
+}
+
+
+static void word_reciprocal(void)
+{
+	Call();
+	Tick(6);
+	if (!math_divisor.at(1) && (math_divisor.at(0) < 2))
+	{
+		Mov(math_quotient, 0xFFFFFFFF);
+		return;
+	}
+
+	Mov(recip_xn, math_mult_a.get());
+	Mov(recip_shift, 1);
+	while (Tick(3), !(recip_xn.at(1) & 0x80))
+	{
+		Shl(recip_xn);
+		recip_shift.at(0)++;
+		Tick(1);
+	}
+
+	Mov(math_mult_a, recip_xn.get());
+	Mov(math_mult_b, 61681);
+	word_multiply();
+	Mov(recip_r, 26985);
+	Sub(recip_r, product_hi.get());
+
+	for (unsigned k = 0; k < 2; k++)
+	{
+		Mov(math_mult_a, recip_xn.get());
+		Mov(math_mult_b, recip_r.get());
+		word_multiply();
+		for (unsigned i = 0; i < 4; i++) math_product.at(i) = ~math_product.at(i);
+		Tick(4);
+		Add(math_product, 1);
+		Mov(math_mult_b, product_hi.get());
+		Add(math_mult_b, 1);
+
+		Mov(math_mult_a, recip_r.get());
+		word_multiply();
+		Sl(math_product.at(1));
+		Slc(math_product.at(2));
+		Slc(math_product.at(3));
+		if (cf) Mov(recip_r, 0xFFFF);
+		else    Mov(recip_r, product_hi.get());
+	}
+
+	Mov(math_quotient, recip_r.get());
+	do Shl(math_quotient);
+	while (Loop(recip_shift));
+}
+
+
+static void BCD_Bits(void)
+{
+	Call();
+	Mov(math_bcd, 0);
+	Mov(math_bcd_h, 0);
+
+	do
+	{
+		for (unsigned i = 0; i < 4; i++) BCD_Adjust(math_bcd.at(i));
+		BCD_Adjust(math_bcd_h.at(0));
+
+		Sl(math_dividend.at(0));
+		for (unsigned i = 1; i < 4; i++) Slc(math_dividend.at(i));
+		BCD_Shift();
+	} while (Loop(counter));
+}
+
+
+static void byte_to_bcd(void)
+{
+	Call();
+	math_dividend.at(3) = math_dividend.at(0);
+	Tick(2);
+	Mov(counter, 8);
+	BCD_Bits();
+}
+
+
+static void word_to_bcd(void)
+{
+	Call();
+	math_dividend.at(3) = math_dividend.at(1);
+	math_dividend.at(2) = math_dividend.at(0);
+	Tick(4);
+	Mov(counter, 16);
+	BCD_Bits();
+}
+
+
+static void eword_to_bcd(void)
+{
+	Call();
+	math_dividend.at(3) = math_dividend.at(2);
+	math_dividend.at(2) = math_dividend.at(1);
+	math_dividend.at(1) = math_dividend.at(0);
+	Tick(6);
+	Mov(counter, 24);
+	BCD_Bits();
+}
+
+
+static void dword_to_bcd(void)
+{
+	Call();
+	Mov(counter, 32);
+	BCD_Bits();
+}
+
+
+static void bcd_unpack(void)
+{
+	Call();
+	Mov(bcd_count, math_shift.get());
+	Mov(counter, (10 - math_shift.get()) & 0xFF);
+	while (Tick(3), counter.at(0))
+	{
+		for (unsigned k = 0; k < 4; k++)
+		{
+			Sl(math_bcd.at(0));
+			for (unsigned i = 1; i < 4; i++) Slc(math_bcd.at(i));
+			Slc(math_bcd_h.at(0));
+		}
+		counter.at(0)--;
+		Tick(1);
+	}
+
+	do
+	{
+		Mov(bcd_digit, 0);
+		for (unsigned k = 0; k < 4; k++)
+		{
+			Sl(math_bcd.at(0));
+			for (unsigned i = 1; i < 4; i++) Slc(math_bcd.at(i));
+			Slc(math_bcd_h.at(0));
+			Slc(bcd_digit.at(0));
+		}
+		ram[math_bcd_ptr.get() & 0xFF] = bcd_digit.at(0);   // idxm
+		Add(math_bcd_ptr, 1);
+		Tick(3);
+	} while (Loop(bcd_count));
+}
+
+
+//=======//
+// CHECK //
+//=======//
+
+static unsigned failures;
+
+struct Worst
+{
+	const char   *name;
+	unsigned long max;
+};
+
+static void Fail(const char *name, uint64_t a, uint64_t b, uint64_t got, uint64_t want);
+
+// A runaway loop reports its cycle count against the limit
+static void Record(Worst &w, unsigned long c)
+{
+	if (c > w.max) w.max = c;
+	if (runaway) Fail(w.name, c, CYCLE_LIMIT, 0, 0);
+}
+
+// Operands a and b, the result and the reference, in hex
+static void Fail(const char *name, uint64_t a, uint64_t b, uint64_t got, uint64_t want)
+{
+	if (failures++ < 20)
+		std::printf("FAIL %-18s 0x%llX, 0x%llX : got 0x%llX want 0x%llX\n", name,
+		            (unsigned long long)a, (unsigned long long)b,
+		            (unsigned long long)got, (unsigned long long)want);
+}
+
+
+static void Clear(void)
+{
+	std::memset(ram, 0xA5, sizeof(ram));   // Stale values, nothing relies on zeroed RAM
+	cycles  = 0;
+	runaway = false;
+}
+
+
+// Packed BCD of v, 10 digits
+static uint64_t Ref_BCD(uint64_t v)
+{
+	uint64_t r = 0;
+	for (unsigned i = 0; i < 10; i++) { r |= (v % 10) << (4 * i); v /= 10; }
+	return r;
+}
+
+
+static void Check_Divide(std::mt19937_64 &rng, unsigned long n)
+{
+	Worst w[4] = { { "byte_divide", 0 }, { "word_divide", 0 }, { "eword_divide", 0 }, { "dword_divide", 0 } };
+	static const unsigned width[4] = { 1, 2, 3, 4 };
+
+	for (unsigned k = 0; k < 4; k++)
+	{
+		uint64_t dmax = (width[k] == 4) ? 0xFFFFFFFFULL : ((1ULL << (8 * width[k])) - 1);
+		uint64_t vmax = (width[k] == 1) ? 0xFF : (width[k] == 2) ? 0xFFFF : 0xFFFFFF;
+		unsigned long cases = (width[k] == 1) ? 256UL * 255 : n;
+		unsigned long by_width[4] = { 0, 0, 0, 0 };   // Worst by dividend bytes, for the zero skip
+
+		for (unsigned long i = 0; i < cases; i++)
+		{
+			uint64_t a, b;
+			if (width[k] == 1) { a = i / 255; b = i % 255 + 1; }
+			else
+			{
+				// Mix operand widths so the zero skip and the short path both run
+				a = rng() & dmax;
+				a >>= rng() % (8 * width[k]);
+				b = (rng() & vmax) >> (rng() % 24);
+				if (i < 16) { a = dmax; b = vmax >> i; }
+				if (!b) b = 1;
+			}
+
+			Clear();
+			math_dividend.set(a);
+			math_divisor.set(b);
+			switch (k)
+			{
+				case 0:  byte_divide();  break;
+				case 1:  word_divide();  break;
+				case 2:  eword_divide(); break;
+				default: dword_divide(); break;
+			}
+			Record(w[k], cycles);
+
+			unsigned bytes = (a >> 24) ? 4 : (a >> 16) ? 3 : (a >> 8) ? 2 : 1;
+			if (cycles > by_width[bytes - 1]) by_width[bytes - 1] = cycles;
+
+			uint64_t q = math_quotient.get(), r = math_remainder.get();
+			if ((q != a / b) || (r != a % b))
+				Fail(w[k].name, a, b, (q << 24) | r, ((a / b) << 24) | (a % b));
+		}
+		std::printf("%-18s worst %5lu cycles  %4lu us\n", w[k].name, w[k].max, w[k].max / 4);
+
+		if (width[k] > 2)
+		{
+			std::printf("%-18s", "  dividend width");
+			for (unsigned i = 0; i < width[k]; i++) std::printf("  %2ub %4lu us", 8 * (i + 1), by_width[i] / 4);
+			std::printf("\n");
+		}
+	}
+}
+
+
+static void Check_Divide_Const(std::mt19937_64 &rng, unsigned long n)
+{
+	Worst w = { "Eword_Divide_Const", 0 };
+	for (unsigned d = 2; d < 256; d++)
+	{
+		for (unsigned long i = 0; i < n / 256 + 16; i++)
+		{
+			uint64_t a = (i < 16) ? (0xFFFFFF - i) : ((rng() & 0xFFFFFF) >> (rng() % 24));
+			Clear();
+			math_dividend.set(a);
+			Eword_Divide_Const(d);
+			Record(w, cycles);
+
+			uint64_t q = math_quotient.get(), r = math_remainder.get();
+			if ((q != a / d) || (r != a % d))
+				Fail(w.name, a, d, (q << 24) | r, ((a / d) << 24) | (a % d));
+		}
+	}
+	std::printf("%-18s worst %5lu cycles  %4lu us\n", w.name, w.max, w.max / 4);
+}
+
+
+static void Check_Multiply(std::mt19937_64 &rng, unsigned long n)
+{
+	Worst w[4] = { { "byte_multiply", 0 }, { "word_multiply", 0 }, { "eword_multiply", 0 }, { "dword_multiply", 0 } };
+
+	for (unsigned long i = 0; i < 65536; i++)
+	{
+		Clear();
+		math_mult_a.set(i >> 8);
+		math_mult_b.set(i & 0xFF);
+		byte_multiply();
+		Record(w[0], cycles);
+		uint64_t want = (i >> 8) * (i & 0xFF);
+		if (math_product.get() != want) Fail(w[0].name, i >> 8, i & 0xFF, math_product.get(), want);
+	}
+
+	for (unsigned long i = 0; i < n; i++)
+	{
+		uint64_t a = rng() & 0xFFFF, b = rng() & 0xFFFF;
+		if (i < 4) { a = (i & 1) ? 0xFFFF : 0; b = (i & 2) ? 0xFFFF : 0; }
+		Clear();
+		math_mult_a.set(a);
+		math_mult_b.set(b);
+		word_multiply();
+		Record(w[1], cycles);
+		if (math_product.get() != a * b) Fail(w[1].name, a, b, math_product.get(), a * b);
+	}
+
+	for (unsigned k = 2; k < 4; k++)
+	{
+		uint64_t m = (k == 2) ? 0xFFFFFF : 0xFFFFFFFF;
+		for (unsigned long i = 0; i < n; i++)
+		{
+			uint64_t a = rng() & m, b = rng() & m;
+			if (i < 4) { a = (i & 1) ? m : 0; b = (i & 2) ? m : 0; }
+			Clear();
+			math_mult_da.set(a);
+			math_mult_db.set(b);
+			if (k == 2) eword_multiply();
+			else        dword_multiply();
+			Record(w[k], cycles);
+
+			uint64_t got = (math_product_h.get() << 32) | math_product.get();
+			if (got != a * b) Fail(w[k].name, a, b, got, a * b);
+		}
+	}
+
+	for (unsigned k = 0; k < 4; k++)
+		std::printf("%-18s worst %5lu cycles  %4lu us\n", w[k].name, w[k].max, w[k].max / 4);
+}
+
+
+static void Check_Sqrt(std::mt19937_64 &rng, unsigned long n)
+{
+	Worst w[2] = { { "word_sqrt", 0 }, { "dword_sqrt", 0 } };
+
+	for (uint64_t v = 0; v < 65536; v++)
+	{
+		Clear();
+		math_dividend.set(v);
+		word_sqrt();
+		Record(w[0], cycles);
+		uint64_t r = math_root.get();
+		if ((r * r > v) || ((r + 1) * (r + 1) <= v)) Fail(w[0].name, v, 0, r, 0);
+	}
+
+	for (unsigned long i = 0; i < n; i++)
+	{
+		uint64_t v = (rng() & 0xFFFFFFFF) >> (rng() % 32);
+		if (i < 3) v = (i == 0) ? 0xFFFFFFFF : (i == 1) ? 0xFFFE0001 : 0xFFFE0000;
+		Clear();
+		math_dividend.set(v);
+		dword_sqrt();
+		Record(w[1], cycles);
+		uint64_t r = math_root.get();
+		if ((r * r > v) || ((r + 1) * (r + 1) <= v)) Fail(w[1].name, v, 0, r, 0);
+	}
+
+	for (unsigned k = 0; k < 2; k++)
+		std::printf("%-18s worst %5lu cycles  %4lu us\n", w[k].name, w[k].max, w[k].max / 4);
+}
+
+
+// Relative error < 0.005%, i.e. 50 ppm
+static void Check_Reciprocal(void)
+{
+	Worst w = { "word_reciprocal", 0 };
+	double worst_ppm = 0;
+
+	for (uint64_t d = 2; d < 65536; d++)
+	{
+		Clear();
+		math_divisor.set(d);
+		word_reciprocal();
+		Record(w, cycles);
+
+		double want = 4294967296.0 / d;
+		double ppm  = ((double)math_quotient.get() - want) / want * 1e6;
+		if (ppm < 0) ppm = -ppm;
+		if (ppm > worst_ppm) worst_ppm = ppm;
+		if (ppm >= 50) Fail(w.name, d, 0, math_quotient.get(), (unsigned long long)want);
+	}
+	std::printf("%-18s worst %5lu cycles  %4lu us  %.1f ppm\n", w.name, w.max, w.max / 4, worst_ppm);
+}
+
+
+static void Check_BCD(std::mt19937_64 &rng, unsigned long n)
+{
+	Worst w[5] = { { "byte_to_bcd", 0 }, { "word_to_bcd", 0 }, { "eword_to_bcd", 0 }, { "dword_to_bcd", 0 }, { "bcd_unpack", 0 } };
+
+	for (unsigned k = 0; k < 4; k++)
+	{
+		uint64_t m = (k == 3) ? 0xFFFFFFFF : ((1ULL << (8 * (k + 1))) - 1);
+		unsigned long cases = (k < 2) ? (unsigned long)(m + 1) : n;
+
+		for (unsigned long i = 0; i < cases; i++)
+		{
+			uint64_t v = (k < 2) ? i : ((rng() & m) >> (rng() % (8 * (k + 1))));
+			if ((k >= 2) && (i < 2)) v = i ? m : 0;
+			Clear();
+			math_dividend.set(v);
+			switch (k)
+			{
+				case 0:  byte_to_bcd();  break;
+				case 1:  word_to_bcd();  break;
+				case 2:  eword_to_bcd(); break;
+				default: dword_to_bcd(); break;
+			}
+			Record(w[k], cycles);
+
+			uint64_t got = ((uint64_t)math_bcd_h.get() << 32) | math_bcd.get();
+			if (got != Ref_BCD(v)) Fail(w[k].name, v, 0, got, Ref_BCD(v));
+		}
+	}
+
+	// Unpack every digit count. The guard bytes either side of the buffer and
+	// the rest of RAM outside the block must come back untouched.
+	for (unsigned long i = 0; i < n / 10 + 10; i++)
+	{
+		uint64_t v      = (i < 10) ? 9876543210ULL : (rng() % 10000000000ULL);
+		unsigned digits = (unsigned)(i % 10) + 1;
+		uint64_t bcd    = Ref_BCD(v);
+
+		Clear();
+		uint8_t before[256];
+		math_bcd.set(bcd & 0xFFFFFFFF);
+		math_bcd_h.set(bcd >> 32);
+		math_bcd_ptr.set(BUF);
+		math_shift.set(digits);
+		std::memcpy(before, ram, sizeof(ram));
+
+		bcd_unpack();
+		Record(w[4], cycles);
+
+		for (unsigned d = 0; d < digits; d++)
+		{
+			unsigned want = (bcd >> (4 * (digits - 1 - d))) & 0xF;
+			if (ram[BUF + d] != want) Fail(w[4].name, v, digits, ram[BUF + d], want);
+		}
+		for (unsigned a = 0; a < 256; a++)
+		{
+			bool inside = ((a >= BUF) && (a < BUF + digits)) || ((a >= BLOCK) && (a < BLOCK + 17));
+			if (!inside && (ram[a] != before[a]))
+			{
+				Fail(w[4].name, v, digits, a, before[a]);
+				break;
+			}
+		}
+	}
+
+	for (unsigned k = 0; k < 5; k++)
+		std::printf("%-18s worst %5lu cycles  %4lu us\n", w[k].name, w[k].max, w[k].max / 4);
+}
+
+
+//======//
+// MAIN //
+//======//
+
+int main(int argc, char **argv)
+{
+	unsigned long n = (argc > 1) ? std::strtoul(argv[1], 0, 10) : 200000;
+	if (!n)
+	{
+		std::fprintf(stderr, "usage: math_model [random cases]\n");
+		return 2;
+	}
+
+	for (unsigned m = 0; m < 2; m++)
+	{
+		std::mt19937_64 rng(2021);
+		has_mul = m;
+		std::printf("\n%s\n", has_mul ? "WITH MULTIPLIER" : "WITHOUT MULTIPLIER");
+
+		Check_Divide(rng, n);
+		Check_Divide_Const(rng, n);
+		Check_Multiply(rng, n);
+		Check_Sqrt(rng, n);
+		Check_Reciprocal();
+		Check_BCD(rng, n);
+	}
+
+	std::printf("\n%s, %u failure%s\n", failures ? "FAILED" : "PASSED", failures, (failures == 1) ? "" : "s");
+	return failures ? 1 : 0;
+}
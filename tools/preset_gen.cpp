@@ -0,0 +1,315 @@
+/* preset_gen.cpp
+
+Host tool that builds ROM preset tables for the 8-bit timers and 11-bit PWM.
+Every prescaler, scalar and bound/counter combination is checked for each
+frequency and the closest one is written out as Mini-C ret tables. Add the
+output to the Padauk IDE project, set the matching *_PRESETS count in
+system_settings.h and switch frequency with Timer2_Apply_Preset() or
+PWM11_0_Apply_Preset() after loading the index into timer8_preset or
+pwm11_preset.
+
+Build:
+	g++ -std=c++11 -O2 -o preset_gen preset_gen.cpp
+
+Usage:
+	preset_gen <channel> <clock_hz> [options] <freq[:duty]> ...
+
+	channel       : tm2, tm3, pwm0, pwm1, pwm2
+	clock_hz      : TIMER8_x_HZ or PWM_x_CLK_HZ from system_settings.h
+	--period      : Timer8 in Period mode (default)
+	--pwm         : Timer8 in PWM mode
+	--6bit        : Timer8 6-bit PWM, matches TIMER8_x_6BIT
+	--duty N      : Default duty percent for entries without :duty (50)
+	-o FILE       : Write to FILE instead of stdout
+
+Example:
+	preset_gen pwm0 4000000 -o pump_presets.c 100 250 500 1000:25
+
+Run once per channel and add every output file to the project.
+Table order follows the command line, so index 0 is the first frequency.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+
+//=======//
+// TYPES //
+//=======//
+
+enum Channel_Kind { KIND_TIMER8, KIND_PWM11 };
+
+struct Channel
+{
+	const char  *arg;      // Command line name
+	const char  *prefix;   // Table function prefix
+	const char  *count;    // Matching system_settings.h count define
+	Channel_Kind kind;
+};
+
+struct Preset
+{
+	double   target_hz;
+	unsigned duty;         // Percent
+	double   actual_hz;
+	unsigned prescaler;    // Register bits, already shifted into place
+	unsigned scalar;
+	unsigned bound;        // Timer8 bound or PWM11 counter
+	unsigned duty_reg;     // Timer8 bound in PWM mode or PWM11 duty
+};
+
+
+static const Channel channels[] =
+{
+	{ "tm2",  "Timer2",  "TIMER8_2_PRESETS", KIND_TIMER8 },
+	{ "tm3",  "Timer3",  "TIMER8_3_PRESETS", KIND_TIMER8 },
+	{ "pwm0", "PWM11_0", "PWM_0_PRESETS",    KIND_PWM11  },
+	{ "pwm1", "PWM11_1", "PWM_1_PRESETS",    KIND_PWM11  },
+	{ "pwm2", "PWM11_2", "PWM_2_PRESETS",    KIND_PWM11  },
+};
+
+static const unsigned prescalers[] = { 1, 4, 16, 64 };
+
+static const unsigned MAX_PRESETS = 64;
+
+
+//========//
+// SOLVER //
+//========//
+
+// Period : f = clk / (2 x P x (S + 1) x (B + 1)), B >= 1, see pdk_timer_8b.c
+// PWM    : f = clk / (P x (S + 1) x depth), bound sets the duty
+static void Solve_Timer8(double clk, bool pwm_mode, unsigned depth, Preset &p)
+{
+	double best = -1;
+
+	for (unsigned ps = 0; ps < 4; ps++)
+	{
+		for (unsigned s = 0; s < 32; s++)
+		{
+			unsigned b_min = pwm_mode ? 0 : 1;
+			unsigned b_max = pwm_mode ? 0 : 255;
+
+			for (unsigned b = b_min; b <= b_max; b++)
+			{
+				double hz;
+				if (pwm_mode) hz = clk / (prescalers[ps] * (s + 1.0) * depth);
+				else          hz = clk / (2.0 * prescalers[ps] * (s + 1.0) * (b + 1.0));
+
+				double err = std::fabs(hz - p.target_hz);
+
+				// Ties keep the smaller prescaler and scalar for finer duty steps
+				if ((best < 0) || (err < best))
+				{
+					best        = err;
+					p.actual_hz = hz;
+					p.prescaler = ps << 5;
+					p.scalar    = s;
+					p.bound     = b;
+				}
+			}
+		}
+	}
+
+	if (pwm_mode)
+	{
+		unsigned steps = (p.duty * depth) / 100;
+		p.duty_reg = steps ? (steps - 1) : 0;
+	}
+	else
+	{
+		p.duty_reg = p.bound;
+	}
+}
+
+
+// f = 2 x clk / (P x (S + 1) x (C + 1)), C + 1 odd and <= 2047, see pdk_pwm_11b.c
+static void Solve_PWM11(double clk, Preset &p)
+{
+	double best = -1;
+
+	for (unsigned ps = 0; ps < 4; ps++)
+	{
+		for (unsigned s = 0; s < 32; s++)
+		{
+			for (unsigned c = 0; c <= 2046; c += 2)
+			{
+				double hz  = (2.0 * clk) / (prescalers[ps] * (s + 1.0) * (c + 1.0));
+				double err = std::fabs(hz - p.target_hz);
+
+				// Ties keep the larger counter for finer duty steps
+				if ((best < 0) || (err < best) || ((err == best) && (c > p.bound)))
+				{
+					best        = err;
+					p.actual_hz = hz;
+					p.prescaler = ps << 5;
+					p.scalar    = s;
+					p.bound     = c;
+				}
+			}
+		}
+	}
+
+	p.duty_reg = ((p.duty * (p.bound + 1)) + 50) / 100;
+}
+
+
+//========//
+// OUTPUT //
+//========//
+
+static void Emit_Table(FILE *out, const char *prefix, const char *field,
+                       const std::vector<Preset> &presets, unsigned (*value)(const Preset &))
+{
+	std::fprintf(out, "void %s_Preset_%s(void)\n{\n\tpcadd A;\n", prefix, field);
+	for (size_t i = 0; i < presets.size(); i++)
+		std::fprintf(out, "\tret 0x%02X;\n", value(presets[i]) & 0xFF);
+	std::fprintf(out, "}\n\n\n");
+}
+
+static unsigned Timer8_Scl    (const Preset &p) { return p.prescaler | p.scalar; }
+static unsigned Timer8_Bnd    (const Preset &p) { return p.duty_reg; }
+static unsigned PWM11_Scl     (const Preset &p) { return p.prescaler | p.scalar; }
+static unsigned PWM11_Cnt_L   (const Preset &p) { return (p.bound    << 5) & 0xFF; }
+static unsigned PWM11_Cnt_H   (const Preset &p) { return (p.bound    >> 3); }
+static unsigned PWM11_Duty_L  (const Preset &p) { return (p.duty_reg << 5) & 0xFF; }
+static unsigned PWM11_Duty_H  (const Preset &p) { return (p.duty_reg >> 3); }
+
+
+static void Emit(FILE *out, const Channel &ch, double clk, const char *mode,
+                 const std::vector<Preset> &presets)
+{
+	std::fprintf(out, "/* %s presets, generated by tools/preset_gen.cpp\n\n", ch.prefix);
+	std::fprintf(out, "Clock : %.0f Hz\n", clk);
+	if (ch.kind == KIND_TIMER8) std::fprintf(out, "Mode  : %s\n", mode);
+	std::fprintf(out, "Set %s to %u in system_settings.h\n\n", ch.count, (unsigned)presets.size());
+	std::fprintf(out, "Index   Target Hz     Result Hz   Error ppm   Duty\n");
+
+	for (size_t i = 0; i < presets.size(); i++)
+	{
+		const Preset &p = presets[i];
+		double ppm = ((p.actual_hz - p.target_hz) / p.target_hz) * 1e6;
+		std::fprintf(out, "%5u  %10.3f  %12.3f  %10.0f   %3u%%\n",
+		             (unsigned)i, p.target_hz, p.actual_hz, ppm, p.duty);
+	}
+	std::fprintf(out, "*/\n\n\n");
+
+	if (ch.kind == KIND_TIMER8)
+	{
+		Emit_Table(out, ch.prefix, "Scl", presets, Timer8_Scl);
+		Emit_Table(out, ch.prefix, "Bnd", presets, Timer8_Bnd);
+	}
+	else
+	{
+		Emit_Table(out, ch.prefix, "Scl",    presets, PWM11_Scl);
+		Emit_Table(out, ch.prefix, "Cnt_L",  presets, PWM11_Cnt_L);
+		Emit_Table(out, ch.prefix, "Cnt_H",  presets, PWM11_Cnt_H);
+		Emit_Table(out, ch.prefix, "Duty_L", presets, PWM11_Duty_L);
+		Emit_Table(out, ch.prefix, "Duty_H", presets, PWM11_Duty_H);
+	}
+}
+
+
+//======//
+// MAIN //
+//======//
+
+static int Usage(void)
+{
+	std::fprintf(stderr,
+		"usage: preset_gen <tm2|tm3|pwm0|pwm1|pwm2> <clock_hz> [--period|--pwm] [--6bit]\n"
+		"                  [--duty N] [-o FILE] <freq[:duty]> ...\n");
+	return 2;
+}
+
+
+int main(int argc, char **argv)
+{
+	if (argc < 4) return Usage();
+
+	const Channel *ch = 0;
+	for (size_t i = 0; i < sizeof(channels) / sizeof(channels[0]); i++)
+		if (!std::strcmp(argv[1], channels[i].arg)) ch = &channels[i];
+	if (!ch) return Usage();
+
+	double clk = std::atof(argv[2]);
+	if (clk <= 0)
+	{
+		std::fprintf(stderr, "preset_gen: clock must be positive\n");
+		return 2;
+	}
+
+	bool        pwm_mode = false;
+	unsigned    depth    = 256;
+	unsigned    duty     = 50;
+	const char *path     = 0;
+	std::vector<Preset> presets;
+
+	for (int i = 3; i < argc; i++)
+	{
+		if      (!std::strcmp(argv[i], "--period")) pwm_mode = false;
+		else if (!std::strcmp(argv[i], "--pwm"))    pwm_mode = true;
+		else if (!std::strcmp(argv[i], "--6bit"))   depth    = 64;
+		else if (!std::strcmp(argv[i], "--duty") && (i + 1 < argc))
+		{
+			char *end;
+			long  d = std::strtol(argv[++i], &end, 10);
+			if ((end == argv[i]) || (*end != '\0') || (d < 0) || (d > 100))
+			{
+				std::fprintf(stderr, "preset_gen: --duty must be 0 to 100, got '%s'\n", argv[i]);
+				return 2;
+			}
+			duty = (unsigned)d;
+		}
+		else if (!std::strcmp(argv[i], "-o")     && (i + 1 < argc)) path = argv[++i];
+		else
+		{
+			Preset p = Preset();
+			char  *end;
+			p.target_hz = std::strtod(argv[i], &end);
+			p.duty      = (*end == ':') ? std::atoi(end + 1) : duty;
+
+			if ((p.target_hz <= 0) || ((*end != ':') && (*end != '\0')) || (p.duty > 100))
+			{
+				std::fprintf(stderr, "preset_gen: bad entry '%s'\n", argv[i]);
+				return 2;
+			}
+			presets.push_back(p);
+		}
+	}
+
+	if (presets.empty() || (presets.size() > MAX_PRESETS))
+	{
+		std::fprintf(stderr, "preset_gen: need 1 to %u frequencies\n", MAX_PRESETS);
+		return 2;
+	}
+
+	for (size_t i = 0; i < presets.size(); i++)
+	{
+		if (ch->kind == KIND_TIMER8) Solve_Timer8(clk, pwm_mode, depth, presets[i]);
+		else                         Solve_PWM11(clk, presets[i]);
+	}
+
+	FILE *out = path ? std::fopen(path, "w") : stdout;
+	if (!out)
+	{
+		std::fprintf(stderr, "preset_gen: cannot open '%s'\n", path);
+		return 1;
+	}
+
+	Emit(out, *ch, clk, pwm_mode ? "PWM" : "Period", presets);
+
+	if (path) std::fclose(out);
+	return 0;
+}
@@ -0,0 +1,427 @@
+/* pwm11_solver_check.cpp
+
+Host check of the 11-bit PWM solvers in pdk_pwm_11b.c.
+
+Divide_Scalar:
+	Both paths, the ROM reciprocal with multiply-back and word_divide, must
+	give the exact quotient and remainder for every ratio 0 to 65535 and
+	every scalar 1 to 32 whose quotient fits the 11-bit counter. The
+	multiplier path is modelled byte for byte.
+
+Solve_PWM_Parameters:
+	The pruned scan must return the same counter, scalar and leftover as
+	the original scan over all 32 scalars, for every ratio 0 to 65535.
+	With pwm11_solve_ppm set it must stop within the tolerance or return
+	the same result.
+
+Solve_PWM_Global (PWM_SOLVE_GLOBAL):
+	For every target from 1 Hz to half the PWM clock, the global result
+	is compared with the default solver and with an exhaustive search of
+	every prescaler, scalar and odd counter. Errors are exact, in clock
+	counts per period. The global solve must never be worse than the
+	default solver. It keeps the ratio to 1/256 and loses fraction bits
+	to each prescaler shift, so it may trail the exhaustive search by up
+	to 2/256 count. The candidate count and the figures quoted in
+	pdk_pwm_11b.c are checked too.
+
+Build:
+	g++ -std=c++11 -O2 -o pwm11_solver_check pwm11_solver_check.cpp
+
+Usage:
+	pwm11_solver_check [pwm clock Hz ...]    (default 1, 4 and 16 MHz)
+
+Exit status is 0 when every check passes. Keep this file in step with
+pdk_pwm_11b.c when a solver changes.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+
+static unsigned failures;
+
+static void Fail(const char *what, uint64_t a, uint64_t b, uint64_t c, uint64_t d)
+{
+	if (failures++ < 20)
+		std::printf("FAIL %-22s %llu %llu : %llu %llu\n", what, (unsigned long long)a,
+		            (unsigned long long)b, (unsigned long long)c, (unsigned long long)d);
+}
+
+
+//===============//
+// DIVIDE_SCALAR //
+//===============//
+
+static bool has_mul;
+
+struct Division
+{
+	unsigned quotient, leftover;
+};
+
+
+// ceil(2^16 / scalar), PWM11_Recip_L / PWM11_Recip_H
+static unsigned Recip(unsigned s) { return (65536 + s - 1) / s; }
+
+
+// math_mult_b = ratio / s, pwm11_leftover = remainder, 16-bit ratio
+static Division Divide_Scalar(unsigned ratio, unsigned s)
+{
+	Division d;
+
+	if (!has_mul)
+	{
+		d.quotient = ratio / s;
+		d.leftover = (ratio % s) & 0xFF;
+		return d;
+	}
+
+	if (s == 1)
+	{
+		d.quotient = ratio;
+		d.leftover = 0;
+		return d;
+	}
+
+	unsigned r0 = ratio & 0xFF, r1 = ratio >> 8;
+	unsigned m0 = Recip(s) & 0xFF, m1 = (Recip(s) >> 8) & 0xFF;
+
+	// math_product$0 = mulrh, then four adds into the DWORD product
+	uint32_t product = (m0 * r0) >> 8;
+	product += (m0 * r1) & 0xFF;
+	product += ((m0 * r1) >> 8) << 8;
+	product += (m1 * r0) & 0xFF;
+	product += ((m1 * r0) >> 8) << 8;
+	product += ((m1 * r1) & 0xFF) << 8;
+	product += ((m1 * r1) >> 8) << 16;
+
+	unsigned q = (product >> 8) & 0xFFFF;
+
+	// Multiply back: low byte x scalar, then the high byte's low product into $1
+	unsigned lo   = (q & 0xFF) * s;
+	unsigned back = ((lo & 0xFF) | ((((lo >> 8) + (((q >> 8) * s) & 0xFF)) & 0xFF) << 8));
+
+	if (back > ratio)
+	{
+		q    = (q - 1) & 0xFFFF;
+		back = (back - s) & 0xFFFF;
+	}
+
+	d.quotient = q;
+	d.leftover = (r0 - (back & 0xFF)) & 0xFF;
+	return d;
+}
+
+
+static void Check_Divide_Scalar(void)
+{
+	for (unsigned ratio = 0; ratio < 65536; ratio++)
+	{
+		for (unsigned s = 1; s <= 32; s++)
+		{
+			if (ratio / s > 2047) continue;	// The scans never ask for these
+			Division d = Divide_Scalar(ratio, s);
+			if ((d.quotient != ratio / s) || (d.leftover != ratio % s))
+				Fail("Divide_Scalar", ratio, s, d.quotient, d.leftover);
+		}
+	}
+}
+
+
+//=======//
+// SCANS //
+//=======//
+
+struct Solution
+{
+	unsigned counter, scalar, leftover;   // Counter and scalar + 1, before the decrement
+};
+
+
+// Baseline Solve_PWM_Parameters scan, word_divide for all 32 scalars
+static Solution Original_Scan(unsigned ratio)
+{
+	Solution r = { 0, 0, 32 };
+	for (unsigned s = 1; s <= 32; s++)
+	{
+		unsigned q = ratio / s, rem = ratio % s;
+		if ((rem < r.leftover) && (q & 1) && (q < 2048))
+		{
+			r.leftover = rem;
+			r.counter  = q;
+			r.scalar   = s;
+		}
+	}
+	return r;
+}
+
+
+// Solve_PWM_Parameters scan. ratio is pwm11_clock_ratio, 24 bits.
+static Solution Pruned_Scan(unsigned ratio, unsigned tol)
+{
+	Solution r = { 0, 0, 32 };
+	unsigned s = ((ratio >> 8) & 0xFF) >> 3;
+	s++;
+	if (ratio >> 16) s = 33;
+
+	while (s < 33)
+	{
+		Division d = Divide_Scalar(ratio & 0xFFFF, s);
+		if ((d.leftover < r.leftover) && (d.quotient & 1))
+		{
+			r.leftover = d.leftover;
+			r.counter  = d.quotient;
+			r.scalar   = s;
+			if (r.leftover <= tol) break;
+		}
+		s++;
+	}
+	return r;
+}
+
+
+static void Check_Scan(void)
+{
+	static const unsigned ppm[] = { 1000, 10000, 50000 };
+
+	for (unsigned ratio = 0; ratio < 65536; ratio++)
+	{
+		Solution a = Original_Scan(ratio);
+		Solution b = Pruned_Scan(ratio, 0);
+		if ((a.counter != b.counter) || (a.scalar != b.scalar) || (a.leftover != b.leftover))
+			Fail("Pruned_Scan", ratio, 0, b.counter, b.scalar);
+
+		for (unsigned k = 0; k < sizeof(ppm) / sizeof(ppm[0]); k++)
+		{
+			// pwm11_solve_tol = ratio x ppm / 2^20, capped at 0xFF
+			unsigned tol = (unsigned)(((uint64_t)ratio * ppm[k]) >> 20);
+			if (tol > 0xFF) tol = 0xFF;
+
+			Solution c = Pruned_Scan(ratio, tol);
+			bool same  = (a.counter == c.counter) && (a.scalar == c.scalar);
+			if (!same && !(c.counter && (c.leftover <= tol) && (c.counter * c.scalar + c.leftover == ratio)))
+				Fail("Pruned_Scan ppm", ratio, ppm[k], c.counter, c.scalar);
+		}
+	}
+}
+
+
+//=========//
+// SOLVERS //
+//=========//
+
+struct Setting
+{
+	unsigned pre, scalar, counter;        // Prescaler 1 to 64, scalar + 1, counter + 1
+};
+
+
+// |2 x clk - target x P x S x C|, clock counts per period x target
+static uint64_t Error(unsigned clk, unsigned target, const Setting &x)
+{
+	uint64_t want = 2ULL * clk;
+	uint64_t got  = (uint64_t)target * x.pre * x.scalar * x.counter;
+	return (got > want) ? (got - want) : (want - got);
+}
+
+
+// Solve_PWM_Parameters with pwm11_solve_ppm = 0
+static Setting Default_Solve(unsigned clk, unsigned target)
+{
+	unsigned ratio = ((clk / target) << 1) & 0xFFFFFF;	// EWORD, as on the chip
+	unsigned shift = 0;
+	while ((ratio > 65504) && (shift < 6)) { ratio >>= 2; shift += 2; }
+
+	Solution r = Pruned_Scan(ratio, 0);
+	Setting  x = { 1u << shift, r.scalar, r.counter };
+	if (!r.counter || !r.scalar) { x.scalar = 32; x.counter = 2047; }
+	return x;
+}
+
+
+// Solve_PWM_Global with pwm11_solve_ppm = 0. candidates counts Divide_Scalar calls.
+static Setting Global_Solve(unsigned clk, unsigned target, unsigned &candidates)
+{
+	uint64_t xi   = (2ULL * clk) / target;
+	uint64_t rem  = (2ULL * clk) % target;
+	uint32_t fx   = (uint32_t)(xi << 8);
+	if (xi >> 24) fx = 0xFFFFFFFF;
+	fx = (fx & 0xFFFFFF00) | (uint32_t)(((rem << 8) / target) & 0xFF);
+
+	uint32_t best_err = 0xFFFFFF;
+	unsigned best_pre = 0, counter = 0, scalar = 0;
+	candidates = 0;
+
+	for (unsigned shift = 0; shift < 8; shift += 2, fx >>= 2)
+	{
+		if (fx >> 24) continue;
+
+		unsigned ratio = (fx >> 8) & 0xFFFF;
+		unsigned s     = (ratio >> 11) + 1;
+		if (shift && (s < 9)) s = 9;
+
+		for (; s < 33; s++)
+		{
+			candidates++;
+			Division d = Divide_Scalar(ratio, s);
+
+			unsigned q   = d.quotient;
+			uint32_t err = (d.leftover << 8) | (fx & 0xFF);
+			if (!(q & 1))
+			{
+				q++;
+				err = ((s << 8) - err) & 0xFFFF;
+			}
+			err <<= shift;
+
+			if (err < best_err)
+			{
+				best_err = err;
+				best_pre = shift;
+				counter  = q;
+				scalar   = s;
+				if (!best_err) { shift = 8; break; }
+			}
+		}
+	}
+
+	Setting x = { 1u << best_pre, scalar, counter };
+	if (!scalar) { x.pre = 64; x.scalar = 32; x.counter = 2047; }
+	return x;
+}
+
+
+// Best of every prescaler, scalar and odd counter. The error is convex in
+// the counter, so the odd counters either side of the ideal one suffice.
+static Setting Exhaustive(unsigned clk, unsigned target)
+{
+	Setting best = { 64, 32, 2047 };
+	uint64_t best_err = Error(clk, target, best);
+
+	for (unsigned pre = 1; pre <= 64; pre <<= 2)
+	{
+		for (unsigned s = 1; s <= 32; s++)
+		{
+			uint64_t q = (2ULL * clk) / ((uint64_t)target * pre * s);
+			uint64_t lo = (q & 1) ? q : (q ? q - 1 : 1);
+			if (lo > 2047) lo = 2047;
+			uint64_t cand[2] = { lo, lo + 2 };
+
+			for (unsigned k = 0; k < 2; k++)
+			{
+				if ((cand[k] < 1) || (cand[k] > 2047)) continue;
+				Setting  x = { pre, s, (unsigned)cand[k] };
+				uint64_t e = Error(clk, target, x);
+				if (e < best_err) { best_err = e; best = x; }
+			}
+		}
+	}
+	return best;
+}
+
+
+static void Check_Global(unsigned clk)
+{
+	unsigned max_candidates = 0, worse_than_default = 0, below_exhaustive = 0;
+	double   worst_excess = 0;
+
+	for (unsigned target = 1; target <= clk / 2; target++)
+	{
+		unsigned n;
+		Setting  g = Global_Solve(clk, target, n);
+		Setting  d = Default_Solve(clk, target);
+		Setting  e = Exhaustive(clk, target);
+		if (n > max_candidates) max_candidates = n;
+
+		// Errors in 1/256 clock counts per period
+		double eg = Error(clk, target, g) * 256.0 / target;
+		double ed = Error(clk, target, d) * 256.0 / target;
+		double ee = Error(clk, target, e) * 256.0 / target;
+		double resolution = 2.0;    // Fraction bits lost to pwm11_ratio_fx >>= 2
+
+		if (eg > ed)
+		{
+			worse_than_default++;
+			Fail("Global worse", clk, target, (uint64_t)eg, (uint64_t)ed);
+		}
+		if (eg > ee)
+		{
+			below_exhaustive++;
+			if (eg - ee > worst_excess) worst_excess = eg - ee;
+			if (eg > ee + resolution) Fail("Global vs exhaustive", clk, target, (uint64_t)eg, (uint64_t)ee);
+		}
+	}
+
+	if (max_candidates > 104) Fail("Global candidates", clk, 0, max_candidates, 104);
+
+	std::printf("global  %8u Hz clock : %u candidates max, %u targets trail the exhaustive search "
+	            "by up to %.2f/256 count, %u worse than default\n",
+	            clk, max_candidates, below_exhaustive, worst_excess, worse_than_default);
+}
+
+
+// Achieved frequency, rounded, for the figures in pdk_pwm_11b.c
+static unsigned Frequency(unsigned clk, const Setting &x)
+{
+	uint64_t div = (uint64_t)x.pre * x.scalar * x.counter;
+	return (unsigned)((2ULL * clk + div / 2) / div);
+}
+
+
+static void Check_Figures(void)
+{
+	static const unsigned figures[][4] =
+	{
+		// Clock, target, default result, global result
+		{ 4000000, 17561, 17621, 17544 },
+		{ 4000000, 14000, 14035, 14011 },
+		{ 4000000,  6500,  6504,  6499 },
+	};
+
+	for (unsigned k = 0; k < sizeof(figures) / sizeof(figures[0]); k++)
+	{
+		unsigned n;
+		unsigned d = Frequency(figures[k][0], Default_Solve(figures[k][0], figures[k][1]));
+		unsigned g = Frequency(figures[k][0], Global_Solve(figures[k][0], figures[k][1], n));
+		if ((d != figures[k][2]) || (g != figures[k][3])) Fail("Figures", figures[k][0], figures[k][1], d, g);
+	}
+}
+
+
+//======//
+// MAIN //
+//======//
+
+int main(int argc, char **argv)
+{
+	for (unsigned m = 0; m < 2; m++)
+	{
+		has_mul = m;
+		Check_Divide_Scalar();
+		Check_Scan();
+	}
+	std::printf("Divide_Scalar and pruned scan checked for ratios 0 to 65535\n");
+
+	has_mul = true;
+	Check_Figures();
+	if (argc > 1)
+		for (int i = 1; i < argc; i++) Check_Global((unsigned)std::strtoul(argv[i], 0, 10));
+	else
+	{
+		Check_Global(1000000);
+		Check_Global(4000000);
+		Check_Global(16000000);
+	}
+
+	std::printf("%s, %u failure%s\n", failures ? "FAILED" : "PASSED", failures, (failures == 1) ? "" : "s");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,188 @@
+/* timer8_walk_check.cpp
+
+Host check of the Timer8 period solver walk in pdk_timer_8b.c. The walk
+is modelled with the same variable widths and the same byte sharing as
+the solver (timer8_quotient / timer8_step_min in timer8_clock_ratio,
+timer8_remainder / timer8_step in timer8_pwm_clk). Every clock ratio
+from 1 to 8192 is then checked against a brute force search over all
+scalar and bound pairs.
+
+For each ratio and tolerance the check requires:
+	- the reported timer8_error is the real |ratio - (S + 1) x (B + 1)|
+	- the scalar and bound fit their registers
+	- with timer8_solve_ppm = 0 the error is the brute force minimum
+	- otherwise the error is within the tolerance or is the minimum
+
+Build:
+	g++ -std=c++11 -O2 -o timer8_walk_check timer8_walk_check.cpp
+
+Exit status is 0 when every check passes. Keep this file in step with
+Timer8_Solve_Period when the walk changes.
+
+
+This software is licensed under GPLv3 <http://www.gnu.org/licenses/>.
+Any modifications or distributions have to be licensed under GPLv3.
+No warranty of any kind and copyright holders cannot be held liable.
+Licensees cannot remove copyright notices.
+
+Copyright (c) 2021 Robert R. Puccinelli
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+
+//=======//
+// MODEL //
+//=======//
+
+struct Result
+{
+	unsigned scalar, bound, error;
+};
+
+
+// EWORD as three bytes, so that aliased writes land where they do on the chip
+struct Eword
+{
+	uint8_t b[3];
+
+	unsigned get(void) const     { return b[0] | (b[1] << 8) | (b[2] << 16); }
+	void     set(unsigned v)     { b[0] = v & 0xFF; b[1] = (v >> 8) & 0xFF; b[2] = (v >> 16) & 0xFF; }
+	unsigned word(void) const    { return b[0] | (b[1] << 8); }
+	void     set_word(unsigned v){ b[0] = v & 0xFF; b[1] = (v >> 8) & 0xFF; }
+};
+
+
+// Timer8_Solve_Period from the ratio check on. tol is timer8_solve_tol.
+static Result Walk(unsigned ratio, unsigned tol)
+{
+	Result r;
+	Eword  clock_ratio, pwm_clk;
+	clock_ratio.set(ratio);
+	pwm_clk.set(0xA5A5A5);
+
+	if (clock_ratio.get() <= 256)
+	{
+		if (!clock_ratio.get()) clock_ratio.set(1);
+		r.scalar = 0;
+		r.bound  = (clock_ratio.b[0] - 1) & 0xFF;
+		r.error  = 0;
+		return r;
+	}
+	if (clock_ratio.get() > 8192) clock_ratio.set(8192);
+
+	// timer8_step = pwm_clk$2, timer8_step_min = clock_ratio$2
+	uint8_t &step     = pwm_clk.b[2];
+	uint8_t &step_min = clock_ratio.b[2];
+	uint8_t  step4, error, scalar = 0, bound = 0;
+
+	step = clock_ratio.b[1];
+	if (clock_ratio.b[0]) step++;
+
+	pwm_clk.set_word(clock_ratio.b[0] & 0x1F);         // timer8_remainder
+	clock_ratio.set_word(clock_ratio.get() >> 5);      // timer8_quotient
+	step_min = step;
+	step     = 32;
+	step4    = 128;
+	error    = 0xFF;
+
+	while (1)
+	{
+		unsigned rem = pwm_clk.word();
+		unsigned quo = clock_ratio.word();
+		uint8_t  a   = (uint8_t)(step - (rem & 0xFF));
+
+		if ((a < (rem & 0xFF)) && (quo < 256))
+		{
+			if (a < error)
+			{
+				error  = a;
+				scalar = step - 1;
+				bound  = quo & 0xFF;
+			}
+		}
+		else if ((rem & 0xFF) < error)
+		{
+			error  = rem & 0xFF;
+			scalar = step - 1;
+			bound  = ((quo & 0xFF) - 1) & 0xFF;
+		}
+
+		if ((error <= tol) || (step == step_min)) break;
+
+		step--;
+		step4 -= 4;
+		rem = (rem + quo) & 0xFFFF;
+
+		while (rem >= step4) { rem = (rem - step4) & 0xFFFF; quo = (quo + 4) & 0xFFFF; }
+		while (rem >= step)  { rem = (rem - step)  & 0xFFFF; quo = (quo + 1) & 0xFFFF; }
+
+		pwm_clk.set_word(rem);
+		clock_ratio.set_word(quo);
+	}
+
+	r.scalar = scalar;
+	r.bound  = bound;
+	r.error  = error;
+	return r;
+}
+
+
+// Smallest |ratio - (S + 1) x (B + 1)| over S [0 : 31], B [0 : 255]
+static unsigned Brute_Force(unsigned ratio)
+{
+	unsigned best = ~0u;
+	for (unsigned s = 1; s <= 32; s++)
+	{
+		for (unsigned b = 1; b <= 256; b++)
+		{
+			unsigned p = s * b;
+			unsigned e = (p > ratio) ? (p - ratio) : (ratio - p);
+			if (e < best) best = e;
+		}
+	}
+	return best;
+}
+
+
+//======//
+// MAIN //
+//======//
+
+int main(void)
+{
+	static const unsigned ppm[] = { 0, 1000, 10000, 50000 };
+	unsigned failures = 0;
+	unsigned worst    = 0;
+
+	for (unsigned ratio = 1; ratio <= 8192; ratio++)
+	{
+		unsigned best = Brute_Force(ratio);
+		if (best > worst) worst = best;
+
+		for (unsigned k = 0; k < sizeof(ppm) / sizeof(ppm[0]); k++)
+		{
+			// timer8_solve_tol = ratio x ppm / 2^20, capped at 0xFF
+			unsigned tol = (unsigned)(((uint64_t)ratio * ppm[k]) >> 20);
+			if (tol > 0xFF) tol = 0xFF;
+
+			Result   r    = Walk(ratio, tol);
+			unsigned p    = (r.scalar + 1) * (r.bound + 1);
+			unsigned real = (p > ratio) ? (p - ratio) : (ratio - p);
+			bool     ok   = (r.scalar < 32) && (r.bound < 256) && (real == r.error);
+
+			if (ppm[k]) ok = ok && ((r.error <= tol) || (r.error == best));
+			else        ok = ok && (r.error == best);
+
+			if (!ok && (failures++ < 20))
+				std::printf("FAIL ratio %4u ppm %5u : S %2u B %3u error %3u (real %u, best %u)\n",
+				            ratio, ppm[k], r.scalar, r.bound, r.error, real, best);
+		}
+	}
+
+	std::printf("ratios 1 to 8192, worst best-case error %u counts\n", worst);
+	std::printf("%s, %u failure%s\n", failures ? "FAILED" : "PASSED", failures, (failures == 1) ? "" : "s");
+	return failures ? 1 : 0;
+}